@@ -5,6 +5,14 @@
 ABC_DIR="./third_party/abc"
 # Path to the ABC binary
 ABC_BIN="$ABC_DIR/abc"
+# Exhaustive simulation checker (src/check/main.cpp)
+CHECKER_BIN="./bin/check/main"
+
+# --- 0. Fast path: simulate against the spec instead of starting ABC ---
+# bin/check/main falls back to cec by itself when the circuit is too wide.
+if [ "$#" -eq 2 ] && [ -x "$CHECKER_BIN" ]; then
+    exec "$CHECKER_BIN" "$1" "$2"
+fi
 
 # --- 1. Check and Build ABC (Preserved) ---
 if [ ! -f "$ABC_BIN" ]; then
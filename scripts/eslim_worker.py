@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# ==============================================================================
+# Persistent eSLIM worker (started by bin/eslim/main, see src/eslim/eslim_session.h)
+#
+# Usage: eslim_worker.py <reduce.py> <request_fd> <reply_fd>
+#
+# The interpreter, the pybind11 bindings and everything reduce.py imports are
+# loaded once.  Each request line holds the reduce.py arguments separated by
+# tabs; the script is re-run in this process with those arguments.  The worker
+# answers on the reply fd with "OK\t<seconds>" or "ERR <message>\t<seconds>".
+# stdout / stderr stay attached to the driver, so eSLIM's own log is unchanged.
+# A "QUIT" line (or EOF) ends the worker.
+# ==============================================================================
+
+import os
+import runpy
+import sys
+import time
+import traceback
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write("usage: eslim_worker.py <reduce.py> <request_fd> <reply_fd>\n")
+        return 2
+
+    script = os.path.abspath(sys.argv[1])
+    requests = os.fdopen(int(sys.argv[2]), "r")
+    replies = os.fdopen(int(sys.argv[3]), "w", buffering=1)
+    sys.path.insert(0, os.path.dirname(script))
+
+    # 先把 reduce.py 的 import（bindings 等）載入一次，之後每個 request 都從 sys.modules 取用
+    # （只是預熱，失敗時每個 request 仍會完整執行 reduce.py）
+    try:
+        sys.argv = [script]
+        runpy.run_path(script, run_name="eslim_warmup")
+    except BaseException as e:
+        sys.stderr.write("[eslim_worker] warm-up skipped: %r\n" % (e,))
+    replies.write("READY\n")
+
+    for line in requests:
+        args = line.rstrip("\n").split("\t")
+        if args == ["QUIT"]:
+            break
+        start = time.time()
+        status = "OK"
+        try:
+            sys.argv = [script] + args
+            runpy.run_path(script, run_name="__main__")
+        except SystemExit as e:
+            if e.code not in (None, 0):
+                status = "ERR exit code %s" % (e.code,)
+        except BaseException as e:
+            traceback.print_exc()
+            status = "ERR " + repr(e).replace("\n", " ").replace("\t", " ")
+        sys.stdout.flush()
+        sys.stderr.flush()
+        replies.write("%s\t%.3f\n" % (status, time.time() - start))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
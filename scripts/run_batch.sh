@@ -17,6 +17,14 @@ export TIME_LIMIT="${2:-1800}" # Default to 600s per case
 # Define cases to run (Space separated, ranges {N..M} allowed)
 CASES=( {20..29} {50..59} {90..99} )
 
+# Native scheduler (src/batch/main.cpp): longest cases first, idle workers
+# steal seed variants of running cases, one pinned core per worker.
+BATCH_BIN="./bin/batch/main"
+if [ -x "$BATCH_BIN" ]; then
+    CASE_LIST=$(IFS=,; echo "${CASES[*]}")
+    exec "$BATCH_BIN" "$BENCH_DIR" "$RESULT_DIR" "workers=$NUM_THREADS" "time_limit=$TIME_LIMIT" "cases=$CASE_LIST"
+fi
+
 # 2. Setup
 mkdir -p "$RESULT_DIR"
 
@@ -6,164 +6,65 @@
 #include <algorithm>
 #include <filesystem>
 #include <cstdint>
-#include <set>
-#include <map>
 
 #include "base/abc/abc.h"
 #include "base/main/main.h"
 
-namespace fs = std::filesystem;
-
-/*** ================== Implicant 結構 ================== ***/
-// mask: 1 = don't care
-// bits: 在 mask=0 的位置上，實際的 0/1
-struct Implicant {
-    uint32_t bits;
-    uint32_t mask;
-
-    bool operator<(const Implicant& other) const {
-        if (mask != other.mask) return mask < other.mask;
-        return bits < other.bits;
-    }
-    bool operator==(const Implicant& other) const {
-        return mask == other.mask && bits == other.bits;
-    }
-};
-
-/*** ================== 小工具函式 ================== ***/
-
-// 展開一個 implicant 所有覆蓋的 minterms（nVars 通常 <= 20）
-void ExpandImplicant(const Implicant& imp, int nVars, std::vector<int>& outMints) {
-    outMints.clear();
-    std::vector<int> dcPos;
-    for (int i = 0; i < nVars; ++i) {
-        if ((imp.mask >> i) & 1u)
-            dcPos.push_back(i);
-    }
-    int numDc = (int)dcPos.size();
-    int combos = 1 << numDc;
-
-    for (int c = 0; c < combos; ++c) {
-        uint32_t val = imp.bits;
-        for (int j = 0; j < numDc; ++j) {
-            int pos = dcPos[j];
-            if ((c >> j) & 1) {
-                val |= (1u << pos);
-            } else {
-                val &= ~(1u << pos);
-            }
-        }
-        outMints.push_back((int)val);
-    }
-}
+#include "common/truth_table.h"
+#include "common/truth_support.h"
+#include "common/parallel.h"
+#include "common/stage_timer.h"
+#include "qm_primes.h"
+#include "qm_cover.h"
+#include "qm_multi.h"
+#include "qm_aig.h"
+#include "qm_zdd.h"
 
-// 嘗試 combine 兩個 implicant
-bool CombineImplicants(const Implicant& a, const Implicant& b, Implicant& out) {
-    if (a.mask != b.mask) return false;
-    uint32_t diff = a.bits ^ b.bits;
-    if (diff == 0) return false;
-    // diff 必須只有一個 bit
-    if (diff & (diff - 1)) return false;
-    // 這個 bit 不能已經是 don't care
-    if (a.mask & diff) return false;
-    out.mask = a.mask | diff;
-    out.bits = a.bits & ~diff;
-    return true;
-}
+namespace fs = std::filesystem;
 
 /*** ================== QM 最小化 ================== ***/
 
 // onset: 包含所有 f(x) = 1 的 minterm index
-// 回傳：一組 implicant（用 greedy cover）
-std::vector<Implicant> QM_Minimize(const std::vector<int>& onset, int nVars) {
+// 回傳：一組 implicant（exact / branch-and-bound cover，時間到改用 greedy 解）
+// 可能在 worker thread 中執行，所以不直接印 log，統計資料放在 pStats / pPrimeNum。
+std::vector<Implicant> QM_Minimize(const std::vector<int>& onset, int nVars, int nThreads,
+                                   const QMCoverParams& coverParams,
+                                   QMCoverStats* pStats = nullptr, size_t* pPrimeNum = nullptr) {
     std::vector<Implicant> result;
     if (onset.empty()) return result; // constant 0
 
-    // 初始集合：每個 minterm 一個 implicant
-    std::set<Implicant> current;
-    for (int m : onset) {
-        Implicant imp;
-        imp.bits = (uint32_t)m;
-        imp.mask = 0u;
-        current.insert(imp);
-    }
-
-    std::set<Implicant> primeImps;
-    std::vector<Implicant> curList;
-
-    while (!current.empty()) {
-        std::set<Implicant> next;
-        std::set<Implicant> used;
-        curList.assign(current.begin(), current.end());
-
-        for (size_t i = 0; i < curList.size(); ++i) {
-            for (size_t j = i + 1; j < curList.size(); ++j) {
-                Implicant comb;
-                if (CombineImplicants(curList[i], curList[j], comb)) {
-                    next.insert(comb);
-                    used.insert(curList[i]);
-                    used.insert(curList[j]);
-                }
-            }
-        }
-
-        for (const auto& imp : current) {
-            if (used.find(imp) == used.end()) {
-                primeImps.insert(imp);
-            }
-        }
-
-        if (next.empty()) break;
-        current.swap(next);
-    }
+    // prime implicants（見 qm_primes.h）
+    std::vector<Implicant> primeImps = QM_GeneratePrimes(onset, nVars, nThreads);
+    if (pPrimeNum) *pPrimeNum = primeImps.size();
 
-    // 建立每個 prime implicant 覆蓋的 onset minterms
-    std::map<Implicant, std::vector<int>> impCover;
-    std::vector<int> expanded;
-    for (const auto& imp : primeImps) {
-        ExpandImplicant(imp, nVars, expanded);
-        std::vector<int> cover;
-        for (int m : expanded) {
-            if (std::find(onset.begin(), onset.end(), m) != onset.end()) {
-                cover.push_back(m);
-            }
-        }
-        if (!cover.empty()) {
-            impCover[imp] = cover;
-        }
-    }
+    // covering（見 qm_cover.h）
+    result = QM_SolveCover(primeImps, onset, nVars, coverParams, pStats);
+    return result;
+}
 
-    // greedy cover
-    std::set<int> uncovered(onset.begin(), onset.end());
-    while (!uncovered.empty()) {
-        Implicant bestImp{};
-        int bestGain = 0;
-        bool found = false;
-
-        for (const auto& kv : impCover) {
-            const Implicant& imp = kv.first;
-            const std::vector<int>& cv = kv.second;
-            int gain = 0;
-            for (int m : cv) {
-                if (uncovered.count(m)) gain++;
-            }
-            if (gain > bestGain) {
-                bestGain = gain;
-                bestImp = imp;
-                found = true;
-            }
-        }
-        if (!found) {
-            std::cerr << "  [WARN] Greedy cover stalled, uncovered size = " << uncovered.size() << "\n";
-            break;
-        }
-        result.push_back(bestImp);
-        for (int m : impCover[bestImp]) {
-            uncovered.erase(m);
+/*** ================== Support 投影還原 ================== ***/
+
+// local 變數 p 對應原本的 x_{support[p]}；不在 support 的變數全是 don't care
+void LiftImplicants(std::vector<Implicant>& imps, const std::vector<int>& support, int nVars) {
+    uint32_t full = nVars >= 32 ? ~0u : (1u << nVars) - 1;
+    for (Implicant& imp : imps) {
+        Implicant g{0, full};
+        for (size_t p = 0; p < support.size(); ++p) {
+            if ((imp.mask >> p) & 1u) continue;
+            g.mask &= ~(1u << support[p]);
+            if ((imp.bits >> p) & 1u) g.bits |= 1u << support[p];
         }
+        imp = g;
     }
+}
 
-    return result;
+// 投影後表格的 onset
+std::vector<int> TruthOnset(const uint64_t* f, int nWords) {
+    std::vector<int> onset;
+    onset.reserve(TruthCountOnes(f, nWords));
+    for (int w = 0; w < nWords; ++w)
+        for (uint64_t bits = f[w]; bits; bits &= bits - 1) onset.push_back(w * 64 + __builtin_ctzll(bits));
+    return onset;
 }
 
 /*** ================== Implicant → Verilog Expr ================== ***/
@@ -191,6 +92,58 @@ std::string ImpToExpr(const Implicant& imp, int nVars) {
     return out.str();
 }
 
+/*** ================== SOP → Verilog（除錯用） ================== ***/
+
+bool WriteSopVerilog(const std::string& verilogFile, const std::string& stem,
+                     const std::vector<std::vector<Implicant>>& allImps, int nVars) {
+    int nOuts = (int)allImps.size();
+    std::ofstream fout(verilogFile);
+    if (!fout.good()) {
+        std::cerr << "Cannot open Verilog output: " << verilogFile << std::endl;
+        return false;
+    }
+
+    // module 宣告
+    fout << "module " << stem << " (";
+    for (int i = 0; i < nVars; ++i) {
+        fout << "x" << i << ", ";
+    }
+    for (int j = 0; j < nOuts; ++j) {
+        fout << "y" << j;
+        if (j + 1 < nOuts) fout << ", ";
+    }
+    fout << ");\n";
+
+    // inputs
+    for (int i = 0; i < nVars; ++i) {
+        fout << "  input x" << i << ";\n";
+    }
+    // outputs
+    for (int j = 0; j < nOuts; ++j) {
+        fout << "  output y" << j << ";\n";
+    }
+
+    // assign yj = ...
+    for (int j = 0; j < nOuts; ++j) {
+        fout << "  assign y" << j << " = ";
+        const auto& imps = allImps[j];
+        if (imps.empty()) {
+            fout << "1'b0;\n";
+            continue;
+        }
+        for (size_t k = 0; k < imps.size(); ++k) {
+            if (k > 0) fout << " | ";
+            fout << "(" << ImpToExpr(imps[k], nVars) << ")";
+        }
+        fout << ";\n";
+    }
+
+    fout << "endmodule\n";
+    fout.close();
+
+    return true;
+}
+
 /*** ================== ABC command helper ================== ***/
 
 bool ExecAbcCmd(Abc_Frame_t* pAbc, const std::string& cmd) {
@@ -205,16 +158,70 @@ bool ExecAbcCmd(Abc_Frame_t* pAbc, const std::string& cmd) {
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: QM <truth_file>" << std::endl;
+        std::cerr << "Usage: QM <truth_file> [options]" << std::endl;
+        std::cerr << "Options (key=value):" << std::endl;
+        std::cerr << "  jobs=<int>         Outputs minimized in parallel, mode=single|zdd; same result as jobs=1 when every cover finishes within cover_time (Default: 1)" << std::endl;
+        std::cerr << "  threads=<int>      Worker threads for prime generation (Default: 1)" << std::endl;
+        std::cerr << "  cover_time=<sec>   Branch-and-bound budget per cover (Default: 10)" << std::endl;
+        std::cerr << "  mode=single|multi|zdd" << std::endl;
+        std::cerr << "                     Per-output QM, shared multi-output primes/cover, or per-output" << std::endl;
+        std::cerr << "                     implicit (BDD/ZDD) primes (Default: single)" << std::endl;
+        std::cerr << "  zdd_nodes=<int>    Node budget of mode=zdd per output (Default: " << QMZddParams().maxNodes << ")" << std::endl;
+        std::cerr << "  verilog=1          Also write the SOP as QM/output/<stem>_qm.v (debug)" << std::endl;
         return 1;
     }
 
     std::string filename = argv[1];
-    std::ifstream fin(filename);
-    if (!fin.good()) {
-        std::cerr << "Cannot open truth file: " << filename << std::endl;
+
+    int nThreads = 1;
+    int nJobs = 1;
+    QMCoverParams coverParams;
+    QMZddParams zddParams;
+    bool multiMode = false;
+    bool zddMode = false;
+    bool dumpVerilog = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.find("jobs=") == 0) {
+            try {
+                nJobs = std::max(1, std::stoi(arg.substr(5)));
+            } catch (...) { std::cerr << "[WARN] Invalid jobs ignored.\n"; }
+        } else if (arg.find("threads=") == 0) {
+            try {
+                nThreads = std::max(1, std::stoi(arg.substr(8)));
+            } catch (...) { std::cerr << "[WARN] Invalid threads ignored.\n"; }
+        } else if (arg.find("cover_time=") == 0) {
+            try {
+                coverParams.timeLimit = std::stod(arg.substr(11));
+            } catch (...) { std::cerr << "[WARN] Invalid cover_time ignored.\n"; }
+        } else if (arg.find("zdd_nodes=") == 0) {
+            try {
+                zddParams.maxNodes = std::max(1024LL, std::stoll(arg.substr(10)));
+            } catch (...) { std::cerr << "[WARN] Invalid zdd_nodes ignored.\n"; }
+        } else if (arg == "mode=multi") {
+            multiMode = true;
+            zddMode = false;
+        } else if (arg == "mode=single") {
+            multiMode = false;
+            zddMode = false;
+        } else if (arg == "mode=zdd") {
+            multiMode = false;
+            zddMode = true;
+        } else if (arg == "verilog=1") {
+            dumpVerilog = true;
+        } else {
+            std::cerr << "[WARN] Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    TruthTable tt;
+    std::string err;
+    StageTimer parseStage("parse");
+    if (!LoadTruthFile(filename, tt, err)) {
+        std::cerr << err << std::endl;
         return 1;
     }
+    parseStage.Stop();
 
     fs::create_directories("QM/output");
 
@@ -227,124 +234,155 @@ int main(int argc, char* argv[]) {
         if (pos != std::string::npos) stem = stem.substr(0, pos);
     }
 
-    // ------- 讀所有行：每行 = 一個 function -------
-    std::vector<std::string> funcs;
-    std::string line;
-    while (std::getline(fin, line)) {
-        // 移除空白
-        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
-        if (line.empty()) continue;
-        funcs.push_back(line);
-    }
-    fin.close();
-
-    if (funcs.empty()) {
-        std::cerr << "No truth table lines found in " << filename << std::endl;
-        return 1;
-    }
-
-    // 檢查每行長度一致
-    size_t L = funcs[0].size();
-    for (size_t i = 1; i < funcs.size(); ++i) {
-        if (funcs[i].size() != L) {
-            std::cerr << "Line " << i << " length mismatch: " << funcs[i].size() << " vs " << L << std::endl;
-            return 1;
-        }
-    }
-
-    // L 應該是 2^n
-    if (L == 0 || (L & (L - 1)) != 0) {
-        std::cerr << "Truth length " << L << " is not power-of-2!\n";
-        return 1;
-    }
-
-    int nVars = 0;
-    while ((1u << nVars) < L) nVars++;
-    int nOuts = (int)funcs.size();
+    int nVars = tt.nVars;
+    int nOuts = tt.nOuts;
+    uint64_t L = tt.nBits;
 
     std::cout << "nVars = " << nVars << ", nOuts = " << nOuts << ", length = " << L << std::endl;
 
-    // ------- fallback 條件：nVars 太大不跑 QM -------
-    if (nVars > 20) {
-        std::cout << "[WARN] nVars = " << nVars << " > 20, QM disabled (no output generated)." << std::endl;
-        return 1;
+    if (multiMode && nOuts > QM_MAX_MULTI_OUTS) {
+        std::cout << "[WARN] nOuts = " << nOuts << " > " << QM_MAX_MULTI_OUTS
+                  << ", falling back to mode=single." << std::endl;
+        multiMode = false;
     }
 
-    // ------- 建每個 output 的 onset -------
-    std::vector<std::vector<int>> onset(nOuts);
-    for (int j = 0; j < nOuts; ++j) {
-        const std::string& f = funcs[j];
-        for (int m = 0; m < (int)L; ++m) {
-            if (f[m] == '1')
-                onset[j].push_back(m);
+    // ------- functional support：每個 output 只在真正依賴的變數上最小化 -------
+    // single/zdd 每個 output 各自投影，multi 投影到所有 output 的聯集；
+    // 結果的 implicant 最後再還原到完整的 nVars
+    StageTimer qmStage("qm");
+    std::vector<std::vector<int>> support(nOuts);
+    std::vector<std::vector<uint64_t>> local(nOuts);
+    std::vector<int> unionSupport;
+    TruthTable projected;
+    int nMaxSupport = 0;
+    if (multiMode) {
+        unionSupport = TruthSupportUnion(tt);
+        TruthProject(tt, unionSupport, projected);
+        nMaxSupport = (int)unionSupport.size();
+        std::cout << "  [QM] Union support = " << nMaxSupport << " / " << nVars << " inputs" << std::endl;
+    } else {
+        for (int j = 0; j < nOuts; ++j) {
+            support[j] = TruthSupport(tt.Output(j), nVars);
+            TruthShrink(tt.Output(j), nVars, support[j], local[j]);
+            nMaxSupport = std::max(nMaxSupport, (int)support[j].size());
         }
     }
 
-    // ------- 對每個 output 跑 QM -------
-    std::vector<std::vector<Implicant>> allImps(nOuts);
-    for (int j = 0; j < nOuts; ++j) {
-        std::cout << "  [QM] Output y" << j << ": onset size = " << onset[j].size() << std::endl;
-        allImps[j] = QM_Minimize(onset[j], nVars);
-        std::cout << "      implicants = " << allImps[j].size() << std::endl;
-    }
-
-    // ------- 寫 multi-output Verilog -------
-    std::string verilogFile = "QM/output/" + stem + "_qm.v";
-    std::ofstream fout(verilogFile);
-    if (!fout.good()) {
-        std::cerr << "Cannot open Verilog output: " << verilogFile << std::endl;
+    // ------- fallback 條件：support 太大不跑 QM -------
+    // explicit QM 以 minterm / cube 列舉，上限 20；mode=zdd 的 prime 是隱式的，
+    // 只剩 covering 需要 2^nVars 的 minterm 表，所以放寬到 QM_ZDD_MAX_VARS
+    int maxVars = zddMode ? QM_ZDD_MAX_VARS : 20;
+    if (nMaxSupport > maxVars) {
+        std::cout << "[WARN] support = " << nMaxSupport << " > " << maxVars << ", QM disabled (no output generated)." << std::endl;
         return 1;
     }
 
-    // module 宣告
-    fout << "module " << stem << " (";
-    for (int i = 0; i < nVars; ++i) {
-        fout << "x" << i << ", ";
-    }
-    for (int j = 0; j < nOuts; ++j) {
-        fout << "y" << j;
-        if (j + 1 < nOuts) fout << ", ";
-    }
-    fout << ");\n";
-
-    // inputs
-    for (int i = 0; i < nVars; ++i) {
-        fout << "  input x" << i << ";\n";
-    }
-    // outputs
-    for (int j = 0; j < nOuts; ++j) {
-        fout << "  output y" << j << ";\n";
-    }
+    // ------- 建每個 output 的 onset（投影後的變數） -------
+    std::vector<std::vector<int>> onset(nOuts);
+    for (int j = 0; j < nOuts; ++j)
+        onset[j] = multiMode ? TruthOnset(projected.Output(j), projected.nWords)
+                             : TruthOnset(local[j].data(), (int)local[j].size());
 
-    // assign yj = ...
-    for (int j = 0; j < nOuts; ++j) {
-        fout << "  assign y" << j << " = ";
-        const auto& imps = allImps[j];
-        if (imps.empty()) {
-            fout << "1'b0;\n";
-            continue;
-        }
-        for (size_t k = 0; k < imps.size(); ++k) {
-            if (k > 0) fout << " | ";
-            fout << "(" << ImpToExpr(imps[k], nVars) << ")";
+    std::vector<std::vector<Implicant>> allImps(nOuts);
+    if (multiMode) {
+        // ------- 所有 output 共用 prime 與 cover -------
+        std::cout << "  [QM] Multi-output mode" << std::endl;
+        int k = projected.nVars;
+        std::vector<MultiImplicant> primes = QM_GenerateMultiPrimes(onset, k, nThreads);
+        QMMultiStats stats;
+        allImps = QM_SolveMultiCover(primes, onset, k, coverParams, &stats);
+        for (int j = 0; j < nOuts; ++j) LiftImplicants(allImps[j], unionSupport, nVars);
+        std::cout << "      primes = " << stats.nPrimes << ", essential = " << stats.cover.nEssential
+                  << ", core = " << stats.cover.nCoreRows << "x" << stats.cover.nCoreCols
+                  << (stats.cover.exact ? " (exact)" : " (budget hit, best found)") << std::endl;
+        std::cout << "      distinct cubes = " << stats.nCubes << ", cube uses = " << stats.nCubeUses << std::endl;
+        for (int j = 0; j < nOuts; ++j)
+            std::cout << "  [QM] Output y" << j << ": onset size = " << onset[j].size()
+                      << ", implicants = " << allImps[j].size() << std::endl;
+    } else {
+        // ------- 對每個 output 跑 QM（outputs 互相獨立，onset 大的先排） -------
+        std::vector<int> order(nOuts);
+        for (int j = 0; j < nOuts; ++j) order[j] = j;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return onset[a].size() > onset[b].size();
+        });
+        std::vector<QMCoverStats> stats(nOuts);
+        std::vector<size_t> primeNum(nOuts, 0);
+        std::vector<QMZddStats> zddStats(nOuts);
+        std::vector<char> zddFailed(nOuts, 0);
+        if (nJobs > 1) std::cout << "  [QM] Minimizing " << nOuts << " outputs on " << nJobs << " workers" << std::endl;
+        ParallelForEach(order, nJobs, [&](int j) {
+            int k = (int)support[j].size();
+            if (zddMode) {
+                if (!QM_ZddMinimize(local[j].data(), onset[j], k, zddParams, coverParams,
+                                    allImps[j], &stats[j], &zddStats[j])) {
+                    // 節點數超過上限：support 夠小就退回 explicit QM
+                    zddFailed[j] = 1;
+                    if (k > 20) return;
+                    allImps[j] = QM_Minimize(onset[j], k, nThreads, coverParams, &stats[j], &primeNum[j]);
+                }
+            } else {
+                allImps[j] = QM_Minimize(onset[j], k, nThreads, coverParams, &stats[j], &primeNum[j]);
+            }
+            LiftImplicants(allImps[j], support[j], nVars);
+        });
+
+        // 依 output 順序輸出 log；每個 cover 都在 cover_time 內跑完時，結果與 worker 數無關
+        // （時間到時的 best-found cover 取決於 worker 跑得多快）
+        for (int j = 0; j < nOuts; ++j) {
+            std::cout << "  [QM] Output y" << j << ": onset size = " << onset[j].size()
+                      << ", support = " << support[j].size() << std::endl;
+            if (zddFailed[j]) {
+                std::cout << "      [WARN] zdd node budget (" << zddParams.maxNodes << ") exceeded";
+                if (support[j].size() > 20) {
+                    std::cout << ", output cannot be minimized." << std::endl;
+                    std::cerr << "[ERROR] QM failed on y" << j << "; raise zdd_nodes." << std::endl;
+                    return 1;
+                }
+                std::cout << ", using explicit QM." << std::endl;
+            }
+            if (!onset[j].empty()) {
+                if (zddMode && !zddFailed[j])
+                    std::cout << "      primes = " << (unsigned long long)zddStats[j].nPrimes
+                              << " (zdd, " << zddStats[j].nNodes << " nodes, " << zddStats[j].nCandidates
+                              << (zddStats[j].implicitCover ? " ISOP-guided candidates)" : " candidates)");
+                else
+                    std::cout << "      primes = " << primeNum[j];
+                std::cout << ", essential = " << stats[j].nEssential
+                          << ", core = " << stats[j].nCoreRows << "x" << stats[j].nCoreCols
+                          << (stats[j].exact ? " (exact)" : " (budget hit, best found)") << std::endl;
+            }
+            std::cout << "      implicants = " << allImps[j].size() << std::endl;
         }
-        fout << ";\n";
     }
 
-    fout << "endmodule\n";
-    fout.close();
+    qmStage.Stop();
 
-    std::cout << "[INFO] SOP Verilog written to " << verilogFile << std::endl;
+    // ------- 只在 verilog=1 時寫出 SOP Verilog -------
+    if (dumpVerilog) {
+        std::string verilogFile = "QM/output/" + stem + "_qm.v";
+        if (!WriteSopVerilog(verilogFile, stem, allImps, nVars)) return 1;
+        std::cout << "[INFO] SOP Verilog written to " << verilogFile << std::endl;
+    }
 
-    // ------- ABC：read_verilog → AIG 最佳化 → write_aiger -------
+    // ------- ABC：直接建 AIG → write_aiger -------
     std::string aigFile = "QM/output/" + stem + "_qm.aig";
 
     Abc_Start();
     Abc_Frame_t* pAbc = Abc_FrameGetGlobalFrame();
 
+    StageTimer buildStage("build");
+    Abc_Ntk_t* pNtk = QM_BuildAig(allImps, nVars, stem);
+    if (!Abc_NtkCheck(pNtk)) {
+        std::cerr << "[ERROR] QM AIG construction failed the network check." << std::endl;
+        Abc_NtkDelete(pNtk);
+        Abc_Stop();
+        return 1;
+    }
+    Abc_FrameReplaceCurrentNetwork(pAbc, pNtk);
+
     std::stringstream cmd;
-    cmd << "read_verilog " << verilogFile << "; "
-        << "strash; " 
+    cmd << "strash; "
         // << "balance; rewrite; rewrite -z; refactor; refactor -z; resub -K 8; dc2; "
         << "print_stats; "
         << "write_aiger " << aigFile;
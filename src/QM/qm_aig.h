@@ -0,0 +1,85 @@
+#ifndef QM_AIG_H
+#define QM_AIG_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/abc/abc.h"
+
+#include "qm_primes.h"
+
+/*** ================== SOP → AIG (in-memory) ================== ***/
+// 直接用 ABC 的 AIG API 建 Abc_Ntk_t，取代 Verilog 寫出再 read_verilog 的流程。
+// - PI 名稱 x0..x{n-1}，PO 名稱 y0..y{m-1}（與原本的 Verilog 相同）
+// - 每個 cube 依變數由小到大串成 AND chain，相同前綴經 strash 自動共用
+// - 相同的 cube 只建一次（跨 output 共用）
+// - 每個 output 的 OR 用平衡樹，避免很深的 chain
+
+class QMAigBuilder {
+public:
+    QMAigBuilder(Abc_Ntk_t* pNtk, int nVars)
+        : pNtk_(pNtk), pMan_((Abc_Aig_t*)pNtk->pManFunc), nVars_(nVars) {}
+
+    Abc_Obj_t* Cube(const Implicant& imp) {
+        uint64_t key = ((uint64_t)imp.mask << 32) | imp.bits;
+        auto it = cubes_.find(key);
+        if (it != cubes_.end()) return it->second;
+        Abc_Obj_t* pRes = Abc_AigConst1(pNtk_);
+        for (int i = 0; i < nVars_; ++i) {
+            uint32_t bit = 1u << i;
+            if (imp.mask & bit) continue;
+            Abc_Obj_t* pLit = Abc_ObjNotCond(Abc_NtkPi(pNtk_, i), !(imp.bits & bit));
+            pRes = Abc_AigAnd(pMan_, pRes, pLit);
+        }
+        cubes_.emplace(key, pRes);
+        return pRes;
+    }
+
+    Abc_Obj_t* Sop(const std::vector<Implicant>& imps) {
+        if (imps.empty()) return Abc_ObjNot(Abc_AigConst1(pNtk_));
+        std::vector<Abc_Obj_t*> level;
+        level.reserve(imps.size());
+        for (const Implicant& imp : imps) level.push_back(Cube(imp));
+        while (level.size() > 1) {
+            std::vector<Abc_Obj_t*> up;
+            up.reserve((level.size() + 1) / 2);
+            for (size_t k = 0; k + 1 < level.size(); k += 2)
+                up.push_back(Abc_AigOr(pMan_, level[k], level[k + 1]));
+            if (level.size() & 1) up.push_back(level.back());
+            level.swap(up);
+        }
+        return level[0];
+    }
+
+    size_t CubeNum() const { return cubes_.size(); }
+
+private:
+    Abc_Ntk_t* pNtk_;
+    Abc_Aig_t* pMan_;
+    int nVars_;
+    std::unordered_map<uint64_t, Abc_Obj_t*> cubes_;
+};
+
+inline Abc_Ntk_t* QM_BuildAig(const std::vector<std::vector<Implicant>>& allImps, int nVars,
+                              const std::string& name) {
+    Abc_Ntk_t* pNtk = Abc_NtkAlloc(ABC_NTK_STRASH, ABC_FUNC_AIG, 1);
+    pNtk->pName = Extra_UtilStrsav(name.c_str());
+
+    for (int i = 0; i < nVars; ++i) {
+        std::string piName = "x" + std::to_string(i);
+        Abc_ObjAssignName(Abc_NtkCreatePi(pNtk), (char*)piName.c_str(), NULL);
+    }
+
+    QMAigBuilder builder(pNtk, nVars);
+    for (size_t j = 0; j < allImps.size(); ++j) {
+        Abc_Obj_t* pPo = Abc_NtkCreatePo(pNtk);
+        Abc_ObjAddFanin(pPo, builder.Sop(allImps[j]));
+        std::string poName = "y" + std::to_string(j);
+        Abc_ObjAssignName(pPo, (char*)poName.c_str(), NULL);
+    }
+    return pNtk;
+}
+
+#endif
@@ -0,0 +1,439 @@
+#ifndef QM_COVER_H
+#define QM_COVER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "qm_primes.h"
+
+/*** ================== Unate covering ================== ***/
+// 行 (row) = prime implicant，列 (column) = onset minterm。
+// 流程：
+//   1. 以 CSR 建 prime × minterm 矩陣（直接列舉 mask 的子集，不再 std::find）
+//   2. 取出 essential primes
+//   3. 剩下的 cyclic core 轉成 dense bitset，反覆做 row / column dominance
+//   4. greedy 得到上界，再跑有時間上限的 branch-and-bound（popcount 下界）
+//   5. 時間用完就用目前最好的解（至少是 greedy 的解）
+// 目標：先最少 cube 數，再最少 literal 數。
+
+struct QMCoverParams {
+    double timeLimit = 10.0;              // B&B 時間上限（秒）
+    uint64_t maxDenseCells = 1ULL << 27;  // cyclic core 轉 dense bitset 的上限 (rows * cols)
+};
+
+struct QMCoverStats {
+    int nEssential = 0;
+    int nCoreRows = 0;
+    int nCoreCols = 0;
+    long nNodes = 0;
+    bool exact = false;   // B&B 是否在時間內跑完
+};
+
+/*** ================== bitset 小工具 ================== ***/
+
+inline int BitsCount(const uint64_t* a, int n) {
+    int c = 0;
+    for (int i = 0; i < n; ++i) c += __builtin_popcountll(a[i]);
+    return c;
+}
+inline int BitsAndCount(const uint64_t* a, const uint64_t* b, int n) {
+    int c = 0;
+    for (int i = 0; i < n; ++i) c += __builtin_popcountll(a[i] & b[i]);
+    return c;
+}
+// (a & m) ⊆ b ?
+inline bool BitsSubsetMasked(const uint64_t* a, const uint64_t* b, const uint64_t* m, int n) {
+    for (int i = 0; i < n; ++i) if (a[i] & m[i] & ~b[i]) return false;
+    return true;
+}
+inline bool BitsIntersect(const uint64_t* a, const uint64_t* b, int n) {
+    for (int i = 0; i < n; ++i) if (a[i] & b[i]) return true;
+    return false;
+}
+inline bool BitsGet(const uint64_t* a, int i) { return (a[i >> 6] >> (i & 63)) & 1; }
+inline void BitsSet(uint64_t* a, int i) { a[i >> 6] |= 1ULL << (i & 63); }
+inline void BitsClear(uint64_t* a, int i) { a[i >> 6] &= ~(1ULL << (i & 63)); }
+
+inline int ImpLiteralNum(const Implicant& imp, int nVars) {
+    return nVars - __builtin_popcount(imp.mask);
+}
+
+/*** ================== Dense cyclic core ================== ***/
+
+struct QMDenseCore {
+    int nRows = 0, nCols = 0;
+    int rowWords = 0, colWords = 0;      // 每個 row bitset / column bitset 的 word 數
+    std::vector<int> rowId;              // core row -> prime index
+    std::vector<int> cost;               // literal 數（tie-break 用）
+    std::vector<uint64_t> rowBits;       // nRows * colWords
+    std::vector<uint64_t> colBits;       // nCols * rowWords
+    std::vector<uint64_t> activeRows;    // rowWords
+    std::vector<uint64_t> activeCols;    // colWords
+
+    uint64_t* Row(int r) { return rowBits.data() + (size_t)r * colWords; }
+    const uint64_t* Row(int r) const { return rowBits.data() + (size_t)r * colWords; }
+    uint64_t* Col(int c) { return colBits.data() + (size_t)c * rowWords; }
+    const uint64_t* Col(int c) const { return colBits.data() + (size_t)c * rowWords; }
+};
+
+// dominance + essential 反覆到不再變化；選到的 core row 放進 chosen
+inline void QM_ReduceCore(QMDenseCore& D, std::vector<int>& chosen,
+                          std::chrono::steady_clock::time_point deadline) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        if (std::chrono::steady_clock::now() > deadline) return;
+
+        // essential：只剩一個 row 能蓋住的 column
+        for (int c = 0; c < D.nCols; ++c) {
+            if (!BitsGet(D.activeCols.data(), c)) continue;
+            int cnt = BitsAndCount(D.Col(c), D.activeRows.data(), D.rowWords);
+            if (cnt != 1) continue;
+            int r = -1;
+            for (int w = 0; w < D.rowWords && r < 0; ++w) {
+                uint64_t x = D.Col(c)[w] & D.activeRows[w];
+                if (x) r = w * 64 + __builtin_ctzll(x);
+            }
+            chosen.push_back(r);
+            BitsClear(D.activeRows.data(), r);
+            for (int w = 0; w < D.colWords; ++w) D.activeCols[w] &= ~D.Row(r)[w];
+            changed = true;
+        }
+
+        // column dominance：rows(c1) ⊇ rows(c2) → 蓋住 c2 就一定蓋住 c1，刪 c1
+        for (int c1 = 0; c1 < D.nCols; ++c1) {
+            if ((c1 & 63) == 0 && std::chrono::steady_clock::now() > deadline) return;
+            if (!BitsGet(D.activeCols.data(), c1)) continue;
+            for (int c2 = 0; c2 < D.nCols; ++c2) {
+                if (c1 == c2 || !BitsGet(D.activeCols.data(), c2)) continue;
+                if (!BitsSubsetMasked(D.Col(c2), D.Col(c1), D.activeRows.data(), D.rowWords)) continue;
+                // 兩列完全相同時只刪 index 較大者
+                if (c2 > c1 && BitsSubsetMasked(D.Col(c1), D.Col(c2), D.activeRows.data(), D.rowWords)) continue;
+                BitsClear(D.activeCols.data(), c1);
+                changed = true;
+                break;
+            }
+        }
+
+        // row dominance：cols(r1) ⊇ cols(r2) 且 cost 不更高 → 刪 r2
+        for (int r2 = 0; r2 < D.nRows; ++r2) {
+            if ((r2 & 63) == 0 && std::chrono::steady_clock::now() > deadline) return;
+            if (!BitsGet(D.activeRows.data(), r2)) continue;
+            if (!BitsIntersect(D.Row(r2), D.activeCols.data(), D.colWords)) {
+                BitsClear(D.activeRows.data(), r2);
+                changed = true;
+                continue;
+            }
+            for (int r1 = 0; r1 < D.nRows; ++r1) {
+                if (r1 == r2 || !BitsGet(D.activeRows.data(), r1)) continue;
+                if (D.cost[r1] > D.cost[r2]) continue;
+                if (!BitsSubsetMasked(D.Row(r2), D.Row(r1), D.activeCols.data(), D.colWords)) continue;
+                if (D.cost[r1] == D.cost[r2] && r1 > r2 &&
+                    BitsSubsetMasked(D.Row(r1), D.Row(r2), D.activeCols.data(), D.colWords)) continue;
+                BitsClear(D.activeRows.data(), r2);
+                changed = true;
+                break;
+            }
+        }
+    }
+}
+
+/*** ================== Branch-and-bound ================== ***/
+
+class QMCoverBnB {
+public:
+    QMCoverBnB(const QMDenseCore& D, std::chrono::steady_clock::time_point deadline)
+        : D_(D), deadline_(deadline) {}
+
+    // 回傳 true 表示搜尋完整結束（best 為最佳解）
+    bool Solve(std::vector<int>& best) {
+        best_ = best;
+        bestCost_ = Cost(best_);
+        std::vector<uint64_t> U(D_.activeCols);
+        std::vector<uint64_t> banned(D_.rowWords, 0);
+        Search(U, banned);
+        best = best_;
+        return !timedOut_;
+    }
+
+    long Nodes() const { return nodes_; }
+
+private:
+    const QMDenseCore& D_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::vector<int> best_, cur_;
+    long bestCost_ = 0;
+    long nodes_ = 0;
+    bool timedOut_ = false;
+
+    // cube 數為主、literal 數為輔
+    long Cost(const std::vector<int>& rows) const {
+        long c = 0;
+        for (int r : rows) c += D_.cost[r];
+        return (long)rows.size() * 1000000L + c;
+    }
+
+    void Search(const std::vector<uint64_t>& U, const std::vector<uint64_t>& banned) {
+        if (timedOut_) return;
+        if ((++nodes_ & 255) == 0 && std::chrono::steady_clock::now() > deadline_) {
+            timedOut_ = true;
+            return;
+        }
+        int nU = BitsCount(U.data(), D_.colWords);
+        if (nU == 0) {
+            long c = Cost(cur_);
+            if (c < bestCost_) { bestCost_ = c; best_ = cur_; }
+            return;
+        }
+
+        std::vector<uint64_t> allowed(D_.rowWords);
+        for (int w = 0; w < D_.rowWords; ++w) allowed[w] = D_.activeRows[w] & ~banned[w];
+
+        // 下界 1：剩下的 minterm 數 / 單一 row 最多能蓋幾個
+        int maxCov = 0;
+        for (int r = 0; r < D_.nRows; ++r)
+            if (BitsGet(allowed.data(), r))
+                maxCov = std::max(maxCov, BitsAndCount(D_.Row(r), U.data(), D_.colWords));
+        if (maxCov == 0) return; // 有 column 蓋不到
+        int lb = (nU + maxCov - 1) / maxCov;
+
+        // 下界 2：兩兩沒有共同 row 的 column 集合；同時挑出分支用的 column（可選 row 最少者）
+        std::vector<uint64_t> rowsUsed(D_.rowWords, 0);
+        int nIndep = 0, branchCol = -1, branchCnt = 1 << 30;
+        for (int w = 0; w < D_.colWords; ++w) {
+            for (uint64_t x = U[w]; x; x &= x - 1) {
+                int c = w * 64 + __builtin_ctzll(x);
+                int cnt = BitsAndCount(D_.Col(c), allowed.data(), D_.rowWords);
+                if (cnt == 0) return; // infeasible
+                if (cnt < branchCnt) { branchCnt = cnt; branchCol = c; }
+                bool disjoint = true;
+                for (int k = 0; k < D_.rowWords && disjoint; ++k)
+                    if (D_.Col(c)[k] & allowed[k] & rowsUsed[k]) disjoint = false;
+                if (disjoint) {
+                    nIndep++;
+                    for (int k = 0; k < D_.rowWords; ++k) rowsUsed[k] |= D_.Col(c)[k] & allowed[k];
+                }
+            }
+        }
+        lb = std::max(lb, nIndep);
+        if (((long)cur_.size() + lb) * 1000000L >= bestCost_) return;
+
+        // 分支：依覆蓋數大到小嘗試；試過的 row 在之後的分支中禁用
+        std::vector<std::pair<int, int>> cand; // (-gain, row)
+        for (int k = 0; k < D_.rowWords; ++k)
+            for (uint64_t x = D_.Col(branchCol)[k] & allowed[k]; x; x &= x - 1) {
+                int r = k * 64 + __builtin_ctzll(x);
+                int gain = BitsAndCount(D_.Row(r), U.data(), D_.colWords);
+                cand.push_back({-(gain * 64 - D_.cost[r]), r});
+            }
+        std::sort(cand.begin(), cand.end());
+
+        std::vector<uint64_t> newBanned(banned);
+        std::vector<uint64_t> newU(D_.colWords);
+        for (const auto& pr : cand) {
+            int r = pr.second;
+            for (int w = 0; w < D_.colWords; ++w) newU[w] = U[w] & ~D_.Row(r)[w];
+            cur_.push_back(r);
+            Search(newU, newBanned);
+            cur_.pop_back();
+            if (timedOut_) return;
+            BitsSet(newBanned.data(), r);
+        }
+    }
+};
+
+/*** ================== Greedy ================== ***/
+
+// 在 dense core 上 greedy：每次挑蓋最多未覆蓋 minterm 的 row（同分取 literal 少者）
+inline std::vector<int> QM_GreedyCore(const QMDenseCore& D) {
+    std::vector<int> chosen;
+    std::vector<uint64_t> U(D.activeCols);
+    while (BitsCount(U.data(), D.colWords) > 0) {
+        int best = -1, bestGain = 0;
+        for (int r = 0; r < D.nRows; ++r) {
+            if (!BitsGet(D.activeRows.data(), r)) continue;
+            int g = BitsAndCount(D.Row(r), U.data(), D.colWords);
+            if (g > bestGain || (g == bestGain && g > 0 && D.cost[r] < D.cost[best])) {
+                bestGain = g;
+                best = r;
+            }
+        }
+        if (best < 0) break;
+        chosen.push_back(best);
+        for (int w = 0; w < D.colWords; ++w) U[w] &= ~D.Row(best)[w];
+    }
+    return chosen;
+}
+
+/*** ================== 主流程 ================== ***/
+
+// 通用的 CSR 版 covering：row r 蓋住 rowCols[rowStart[r] .. rowStart[r+1])，
+// rowCost 為 literal 數（同 cube 數時的 tie-break）。回傳選中的 row（已去除多餘者）。
+inline std::vector<int> QM_SolveCoverCSR(int nCols, const std::vector<int>& rowStart,
+                                         const std::vector<int>& rowCols,
+                                         const std::vector<int>& rowCost,
+                                         const QMCoverParams& params,
+                                         QMCoverStats* pStats = nullptr) {
+    QMCoverStats stats;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds((long long)(params.timeLimit * 1e6));
+    int nRows = (int)rowStart.size() - 1;
+
+    // ---- 1. column -> rows ----
+    std::vector<int> colCount(nCols, 0);
+    for (int c : rowCols) colCount[c]++;
+    std::vector<int> colStart(nCols + 1, 0);
+    for (int c = 0; c < nCols; ++c) colStart[c + 1] = colStart[c] + colCount[c];
+    std::vector<int> colRows(rowCols.size());
+    {
+        std::vector<int> fill(colStart.begin(), colStart.end() - 1);
+        for (int r = 0; r < nRows; ++r)
+            for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) colRows[fill[rowCols[k]]++] = r;
+    }
+
+    // ---- 2. essential primes ----
+    std::vector<char> rowSel(nRows, 0), colCovered(nCols, 0);
+    for (int c = 0; c < nCols; ++c) {
+        if (colCovered[c] || colStart[c + 1] - colStart[c] != 1) continue;
+        int r = colRows[colStart[c]];
+        if (rowSel[r]) continue;
+        rowSel[r] = 1;
+        stats.nEssential++;
+        for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) colCovered[rowCols[k]] = 1;
+    }
+
+    // ---- 3. cyclic core ----
+    std::vector<int> coreCols, coreColIdx(nCols, -1);
+    for (int c = 0; c < nCols; ++c)
+        if (!colCovered[c]) { coreColIdx[c] = (int)coreCols.size(); coreCols.push_back(c); }
+    std::vector<int> coreRows;
+    for (int r = 0; r < nRows; ++r) {
+        if (rowSel[r]) continue;
+        for (int k = rowStart[r]; k < rowStart[r + 1]; ++k)
+            if (!colCovered[rowCols[k]]) { coreRows.push_back(r); break; }
+    }
+    stats.nCoreRows = (int)coreRows.size();
+    stats.nCoreCols = (int)coreCols.size();
+    stats.exact = coreCols.empty();
+
+    if (!coreCols.empty() &&
+        (uint64_t)coreRows.size() * coreCols.size() <= params.maxDenseCells) {
+        QMDenseCore D;
+        D.nRows = (int)coreRows.size();
+        D.nCols = (int)coreCols.size();
+        D.rowWords = (D.nRows + 63) / 64;
+        D.colWords = (D.nCols + 63) / 64;
+        D.rowId = coreRows;
+        D.rowBits.assign((size_t)D.nRows * D.colWords, 0);
+        D.colBits.assign((size_t)D.nCols * D.rowWords, 0);
+        D.activeRows.assign(D.rowWords, 0);
+        D.activeCols.assign(D.colWords, 0);
+        for (int i = 0; i < D.nRows; ++i) {
+            int r = coreRows[i];
+            D.cost.push_back(rowCost[r]);
+            BitsSet(D.activeRows.data(), i);
+            for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) {
+                int j = coreColIdx[rowCols[k]];
+                if (j < 0) continue;
+                BitsSet(D.Row(i), j);
+                BitsSet(D.Col(j), i);
+            }
+        }
+        for (int j = 0; j < D.nCols; ++j) BitsSet(D.activeCols.data(), j);
+
+        std::vector<int> chosen;
+        QM_ReduceCore(D, chosen, deadline);
+        std::vector<int> sol = QM_GreedyCore(D);
+        QMCoverBnB bnb(D, deadline);
+        stats.exact = bnb.Solve(sol);
+        stats.nNodes = bnb.Nodes();
+        chosen.insert(chosen.end(), sol.begin(), sol.end());
+        for (int i : chosen) rowSel[D.rowId[i]] = 1;
+    } else if (!coreCols.empty()) {
+        // core 太大：CSR 上的 greedy（gain 增量更新）
+        std::vector<int> gain(nRows, 0);
+        for (int r : coreRows)
+            for (int k = rowStart[r]; k < rowStart[r + 1]; ++k)
+                if (!colCovered[rowCols[k]]) gain[r]++;
+        size_t left = coreCols.size();
+        while (left > 0) {
+            int best = -1;
+            for (int r : coreRows) {
+                if (rowSel[r] || gain[r] == 0) continue;
+                if (best < 0 || gain[r] > gain[best] ||
+                    (gain[r] == gain[best] && rowCost[r] < rowCost[best]))
+                    best = r;
+            }
+            if (best < 0) break;
+            rowSel[best] = 1;
+            for (int k = rowStart[best]; k < rowStart[best + 1]; ++k) {
+                int c = rowCols[k];
+                if (colCovered[c]) continue;
+                colCovered[c] = 1;
+                left--;
+                for (int q = colStart[c]; q < colStart[c + 1]; ++q) gain[colRows[q]]--;
+            }
+        }
+    }
+
+    // ---- 4. 去掉多餘的 row（literal 多的先試） ----
+    std::vector<int> sel;
+    for (int r = 0; r < nRows; ++r) if (rowSel[r]) sel.push_back(r);
+    std::vector<int> coverCnt(nCols, 0);
+    for (int r : sel)
+        for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) coverCnt[rowCols[k]]++;
+    std::sort(sel.begin(), sel.end(), [&](int a, int b) {
+        return rowCost[a] > rowCost[b];
+    });
+    std::vector<int> result;
+    for (int r : sel) {
+        bool redundant = true;
+        for (int k = rowStart[r]; k < rowStart[r + 1] && redundant; ++k)
+            if (coverCnt[rowCols[k]] < 2) redundant = false;
+        if (redundant) {
+            for (int k = rowStart[r]; k < rowStart[r + 1]; ++k) coverCnt[rowCols[k]]--;
+            continue;
+        }
+        result.push_back(r);
+    }
+    std::sort(result.begin(), result.end());
+
+    if (pStats) *pStats = stats;
+    return result;
+}
+
+// 單一 output：column = onset minterm
+inline std::vector<Implicant> QM_SolveCover(const std::vector<Implicant>& primes,
+                                            const std::vector<int>& onset, int nVars,
+                                            const QMCoverParams& params,
+                                            QMCoverStats* pStats = nullptr) {
+    int nRows = (int)primes.size();
+    int nCols = (int)onset.size();
+
+    // CSR：prime -> columns
+    std::vector<int> colOf((size_t)1 << nVars, -1);
+    for (int c = 0; c < nCols; ++c) colOf[onset[c]] = c;
+
+    std::vector<int> rowStart(nRows + 1, 0);
+    std::vector<int> rowCols, rowCost(nRows);
+    for (int r = 0; r < nRows; ++r) {
+        uint32_t mask = primes[r].mask;
+        uint32_t sub = 0;
+        do {
+            int c = colOf[primes[r].bits | sub];
+            if (c >= 0) rowCols.push_back(c);
+            sub = (sub - mask) & mask;   // 下一個 mask 子集
+        } while (sub != 0);
+        rowStart[r + 1] = (int)rowCols.size();
+        rowCost[r] = ImpLiteralNum(primes[r], nVars);
+    }
+
+    std::vector<Implicant> result;
+    for (int r : QM_SolveCoverCSR(nCols, rowStart, rowCols, rowCost, params, pStats))
+        result.push_back(primes[r]);
+    return result;
+}
+
+#endif
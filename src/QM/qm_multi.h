@@ -0,0 +1,250 @@
+#ifndef QM_MULTI_H
+#define QM_MULTI_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "qm_primes.h"
+#include "qm_cover.h"
+
+/*** ================== Multi-output implicant ================== ***/
+// tag 的 bit j = 這個 cube 是 output j 的 implicant（最多 64 個 output）。
+// 從 minterm 開始，tag = 含有該 minterm 的 output 集合；合併時 tag 取交集，
+// 因此每個 cube 的 tag 恰好是「整個 cube 都在 onset 裡」的 output 集合。
+// (cube, tag) 是 multi-output prime ⇔ 沒有任何一個單 bit 擴張仍保有同樣的 tag。
+struct MultiImplicant {
+    uint32_t bits;
+    uint32_t mask;
+    uint64_t tag;
+
+    bool operator<(const MultiImplicant& other) const {
+        if (mask != other.mask) return mask < other.mask;
+        return bits < other.bits;
+    }
+    bool operator==(const MultiImplicant& other) const {
+        return mask == other.mask && bits == other.bits;
+    }
+};
+
+static const int QM_MAX_MULTI_OUTS = 64;
+
+/*** ================== (mask, bits) -> tag ================== ***/
+
+class CubeTagMap {
+public:
+    void Build(const std::vector<MultiImplicant>& cubes) {
+        size_t cap = 16;
+        while (cap < cubes.size() * 2) cap <<= 1;
+        keys_.assign(cap, kEmpty);
+        tags_.assign(cap, 0);
+        capMask_ = cap - 1;
+        for (const MultiImplicant& c : cubes) {
+            uint64_t key = Key(c.mask, c.bits);
+            size_t h = Hash(key) & capMask_;
+            while (keys_[h] != kEmpty && keys_[h] != key) h = (h + 1) & capMask_;
+            keys_[h] = key;
+            tags_[h] = c.tag;
+        }
+    }
+
+    // 不存在回傳 0
+    uint64_t Find(uint32_t mask, uint32_t bits) const {
+        uint64_t key = Key(mask, bits);
+        size_t h = Hash(key) & capMask_;
+        while (keys_[h] != kEmpty) {
+            if (keys_[h] == key) return tags_[h];
+            h = (h + 1) & capMask_;
+        }
+        return 0;
+    }
+
+private:
+    static constexpr uint64_t kEmpty = ~0ULL;
+    std::vector<uint64_t> keys_;
+    std::vector<uint64_t> tags_;
+    size_t capMask_ = 0;
+
+    static uint64_t Key(uint32_t mask, uint32_t bits) { return ((uint64_t)mask << 32) | bits; }
+    static size_t Hash(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return (size_t)k;
+    }
+};
+
+/*** ================== Multi-output prime 產生 ================== ***/
+
+inline void QM_MultiCombineRange(const std::vector<MultiImplicant>& cur, const CubeTagMap& index,
+                                 size_t lo, size_t hi, int nVars,
+                                 std::vector<MultiImplicant>& next, std::vector<MultiImplicant>& primes) {
+    for (size_t i = lo; i < hi; ++i) {
+        const MultiImplicant& c = cur[i];
+        bool used = false;
+        for (int v = 0; v < nVars; ++v) {
+            uint32_t bit = 1u << v;
+            if (c.mask & bit) continue;
+            uint64_t tag = c.tag & index.Find(c.mask, c.bits ^ bit);
+            if (tag == 0) continue;
+            if (tag == c.tag) used = true;
+            if (!(c.bits & bit)) next.push_back({c.bits, c.mask | bit, tag});
+        }
+        if (!used) primes.push_back(c);
+    }
+}
+
+// 所有 output 一起產生 prime，共用的 cube 只產生一次
+inline std::vector<MultiImplicant> QM_GenerateMultiPrimes(const std::vector<std::vector<int>>& onset,
+                                                          int nVars, int nThreads = 1) {
+    std::vector<uint64_t> mintermTag((size_t)1 << nVars, 0);
+    for (size_t j = 0; j < onset.size(); ++j)
+        for (int m : onset[j]) mintermTag[m] |= 1ULL << j;
+
+    std::vector<MultiImplicant> primes;
+    std::vector<MultiImplicant> cur, next;
+    for (size_t m = 0; m < mintermTag.size(); ++m)
+        if (mintermTag[m]) cur.push_back({(uint32_t)m, 0u, mintermTag[m]});
+    mintermTag.clear();
+    mintermTag.shrink_to_fit();
+
+    const size_t kMinParallel = 1 << 14;
+    CubeTagMap index;
+
+    while (!cur.empty()) {
+        std::sort(cur.begin(), cur.end(), [](const MultiImplicant& a, const MultiImplicant& b) {
+            if (a.mask != b.mask) return a.mask < b.mask;
+            int pa = __builtin_popcount(a.bits), pb = __builtin_popcount(b.bits);
+            if (pa != pb) return pa < pb;
+            return a.bits < b.bits;
+        });
+        cur.erase(std::unique(cur.begin(), cur.end()), cur.end());
+        index.Build(cur);
+
+        next.clear();
+        int nChunks = (nThreads > 1 && cur.size() >= kMinParallel) ? nThreads : 1;
+        if (nChunks == 1) {
+            QM_MultiCombineRange(cur, index, 0, cur.size(), nVars, next, primes);
+        } else {
+            std::vector<std::vector<MultiImplicant>> nextPart(nChunks), primePart(nChunks);
+            std::vector<std::thread> workers;
+            size_t step = (cur.size() + nChunks - 1) / nChunks;
+            for (int t = 0; t < nChunks; ++t) {
+                size_t lo = std::min(cur.size(), t * step);
+                size_t hi = std::min(cur.size(), lo + step);
+                workers.emplace_back([&, t, lo, hi]() {
+                    QM_MultiCombineRange(cur, index, lo, hi, nVars, nextPart[t], primePart[t]);
+                });
+            }
+            for (auto& w : workers) w.join();
+            for (int t = 0; t < nChunks; ++t) {
+                next.insert(next.end(), nextPart[t].begin(), nextPart[t].end());
+                primes.insert(primes.end(), primePart[t].begin(), primePart[t].end());
+            }
+        }
+        cur.swap(next);
+    }
+
+    std::sort(primes.begin(), primes.end());
+    return primes;
+}
+
+/*** ================== Multi-output covering ================== ***/
+// column = (output, onset minterm)；row = multi-output prime，蓋住 tag 內每個 output 的 minterm。
+// 以 cube 數為主要成本，一個 cube 同時供多個 output 使用只算一次，所以共用的 cube 會被偏好。
+// 選完之後每個 output 各自再去掉多餘的 cube。
+
+struct QMMultiStats {
+    QMCoverStats cover;
+    int nPrimes = 0;
+    int nCubes = 0;        // 選中的相異 cube 數
+    int nCubeUses = 0;     // 所有 output 使用 cube 的總次數
+};
+
+inline std::vector<std::vector<Implicant>> QM_SolveMultiCover(const std::vector<MultiImplicant>& primes,
+                                                              const std::vector<std::vector<int>>& onset,
+                                                              int nVars, const QMCoverParams& params,
+                                                              QMMultiStats* pStats = nullptr) {
+    int nOuts = (int)onset.size();
+    int nRows = (int)primes.size();
+
+    std::vector<int> colBase(nOuts + 1, 0);
+    for (int j = 0; j < nOuts; ++j) colBase[j + 1] = colBase[j] + (int)onset[j].size();
+
+    // (row, column) pairs，逐個 output 填 colOf 以免同時持有 nOuts 張表
+    std::vector<int> colOf((size_t)1 << nVars, -1);
+    std::vector<int> rowCount(nRows, 0);
+    std::vector<std::pair<int, int>> cells;
+    for (int j = 0; j < nOuts; ++j) {
+        for (size_t k = 0; k < onset[j].size(); ++k) colOf[onset[j][k]] = colBase[j] + (int)k;
+        for (int r = 0; r < nRows; ++r) {
+            if (!((primes[r].tag >> j) & 1)) continue;
+            uint32_t mask = primes[r].mask, sub = 0;
+            do {
+                cells.push_back({r, colOf[primes[r].bits | sub]});
+                rowCount[r]++;
+                sub = (sub - mask) & mask;
+            } while (sub != 0);
+        }
+        for (int m : onset[j]) colOf[m] = -1;
+    }
+
+    std::vector<int> rowStart(nRows + 1, 0);
+    for (int r = 0; r < nRows; ++r) rowStart[r + 1] = rowStart[r] + rowCount[r];
+    std::vector<int> rowCols(cells.size());
+    {
+        std::vector<int> fill(rowStart.begin(), rowStart.end() - 1);
+        for (const auto& cell : cells) rowCols[fill[cell.first]++] = cell.second;
+    }
+    cells.clear();
+    cells.shrink_to_fit();
+
+    std::vector<int> rowCost(nRows);
+    for (int r = 0; r < nRows; ++r) rowCost[r] = nVars - __builtin_popcount(primes[r].mask);
+
+    QMMultiStats stats;
+    stats.nPrimes = nRows;
+    std::vector<int> chosen = QM_SolveCoverCSR(colBase[nOuts], rowStart, rowCols, rowCost, params, &stats.cover);
+
+    // 逐 output 拆開，再做 per-output 的去冗餘（literal 多者先試）
+    std::sort(chosen.begin(), chosen.end(), [&](int a, int b) { return rowCost[a] > rowCost[b]; });
+    std::vector<std::vector<Implicant>> result(nOuts);
+    std::vector<char> used(nRows, 0);
+    std::vector<int> coverCnt((size_t)1 << nVars, 0);
+    for (int j = 0; j < nOuts; ++j) {
+        std::vector<int> rows;
+        for (int r : chosen) if ((primes[r].tag >> j) & 1) rows.push_back(r);
+        for (int r : rows) {
+            uint32_t mask = primes[r].mask, sub = 0;
+            do { coverCnt[primes[r].bits | sub]++; sub = (sub - mask) & mask; } while (sub != 0);
+        }
+        for (int r : rows) {
+            uint32_t mask = primes[r].mask, sub = 0;
+            bool redundant = true;
+            do {
+                if (coverCnt[primes[r].bits | sub] < 2) { redundant = false; break; }
+                sub = (sub - mask) & mask;
+            } while (sub != 0);
+            if (redundant) {
+                sub = 0;
+                do { coverCnt[primes[r].bits | sub]--; sub = (sub - mask) & mask; } while (sub != 0);
+                continue;
+            }
+            result[j].push_back({primes[r].bits, primes[r].mask});
+            used[r] = 1;
+        }
+        for (int r : rows) {
+            uint32_t mask = primes[r].mask, sub = 0;
+            do { coverCnt[primes[r].bits | sub] = 0; sub = (sub - mask) & mask; } while (sub != 0);
+        }
+        std::sort(result[j].begin(), result[j].end());
+        stats.nCubeUses += (int)result[j].size();
+    }
+    for (int r = 0; r < nRows; ++r) stats.nCubes += used[r];
+
+    if (pStats) *pStats = stats;
+    return result;
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef QM_PRIMES_H
+#define QM_PRIMES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/*** ================== Implicant 結構 ================== ***/
+// mask: 1 = don't care
+// bits: 在 mask=0 的位置上，實際的 0/1
+struct Implicant {
+    uint32_t bits;
+    uint32_t mask;
+
+    bool operator<(const Implicant& other) const {
+        if (mask != other.mask) return mask < other.mask;
+        return bits < other.bits;
+    }
+    bool operator==(const Implicant& other) const {
+        return mask == other.mask && bits == other.bits;
+    }
+};
+
+/*** ================== Cube hash (open addressing) ================== ***/
+// 以 (mask, bits) 為 key 的扁平 hash set，陣列在每一層之間重複使用。
+// key = ~0 不可能出現（mask 位置上的 bits 一定是 0），拿來當空槽。
+class CubeHashSet {
+public:
+    void Build(const std::vector<Implicant>& cubes) {
+        size_t cap = 16;
+        while (cap < cubes.size() * 2) cap <<= 1;
+        slots_.assign(cap, kEmpty);
+        capMask_ = cap - 1;
+        for (const Implicant& c : cubes) {
+            uint64_t key = Key(c.mask, c.bits);
+            size_t h = Hash(key) & capMask_;
+            while (slots_[h] != kEmpty && slots_[h] != key) h = (h + 1) & capMask_;
+            slots_[h] = key;
+        }
+    }
+
+    bool Contains(uint32_t mask, uint32_t bits) const {
+        uint64_t key = Key(mask, bits);
+        size_t h = Hash(key) & capMask_;
+        while (slots_[h] != kEmpty) {
+            if (slots_[h] == key) return true;
+            h = (h + 1) & capMask_;
+        }
+        return false;
+    }
+
+private:
+    static constexpr uint64_t kEmpty = ~0ULL;
+    std::vector<uint64_t> slots_;
+    size_t capMask_ = 0;
+
+    static uint64_t Key(uint32_t mask, uint32_t bits) { return ((uint64_t)mask << 32) | bits; }
+    static size_t Hash(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        return (size_t)k;
+    }
+};
+
+/*** ================== Prime implicant 產生 ================== ***/
+
+// 一層的 combine：cur[lo, hi) 中每個 cube 翻轉一個非 don't-care 的 bit 去 hash 裡找夥伴。
+// 找得到 → 不是 prime；只有自己該 bit 為 0 的那一方負責產生合併後的 cube，避免重複。
+inline void QM_CombineRange(const std::vector<Implicant>& cur, const CubeHashSet& index,
+                            size_t lo, size_t hi, int nVars,
+                            std::vector<Implicant>& next, std::vector<Implicant>& primes) {
+    for (size_t i = lo; i < hi; ++i) {
+        const Implicant& c = cur[i];
+        bool used = false;
+        for (int v = 0; v < nVars; ++v) {
+            uint32_t bit = 1u << v;
+            if (c.mask & bit) continue;
+            if (!index.Contains(c.mask, c.bits ^ bit)) continue;
+            used = true;
+            if (!(c.bits & bit)) next.push_back({c.bits, c.mask | bit});
+        }
+        if (!used) primes.push_back(c);
+    }
+}
+
+// 取代逐對比較：每一層依 (mask, popcount, bits) 排序後建 hash，
+// 合併夥伴用「翻一個 bit 查表」取得，複雜度 O(k * nVars) 而非 O(k^2)。
+// nThreads > 1 時每一層的 combine 依區段平行處理，結果依區段順序接回，與執行緒數無關。
+inline std::vector<Implicant> QM_GeneratePrimes(const std::vector<int>& onset, int nVars, int nThreads = 1) {
+    std::vector<Implicant> primes;
+    std::vector<Implicant> cur, next;
+    cur.reserve(onset.size());
+    for (int m : onset) cur.push_back({(uint32_t)m, 0u});
+
+    const size_t kMinParallel = 1 << 14;
+    CubeHashSet index;
+
+    while (!cur.empty()) {
+        std::sort(cur.begin(), cur.end(), [](const Implicant& a, const Implicant& b) {
+            if (a.mask != b.mask) return a.mask < b.mask;
+            int pa = __builtin_popcount(a.bits), pb = __builtin_popcount(b.bits);
+            if (pa != pb) return pa < pb;
+            return a.bits < b.bits;
+        });
+        cur.erase(std::unique(cur.begin(), cur.end()), cur.end());
+        index.Build(cur);
+
+        next.clear();
+        int nChunks = (nThreads > 1 && cur.size() >= kMinParallel) ? nThreads : 1;
+        if (nChunks == 1) {
+            QM_CombineRange(cur, index, 0, cur.size(), nVars, next, primes);
+        } else {
+            std::vector<std::vector<Implicant>> nextPart(nChunks), primePart(nChunks);
+            std::vector<std::thread> workers;
+            size_t step = (cur.size() + nChunks - 1) / nChunks;
+            for (int t = 0; t < nChunks; ++t) {
+                size_t lo = std::min(cur.size(), t * step);
+                size_t hi = std::min(cur.size(), lo + step);
+                workers.emplace_back([&, t, lo, hi]() {
+                    QM_CombineRange(cur, index, lo, hi, nVars, nextPart[t], primePart[t]);
+                });
+            }
+            for (auto& w : workers) w.join();
+            for (int t = 0; t < nChunks; ++t) {
+                next.insert(next.end(), nextPart[t].begin(), nextPart[t].end());
+                primes.insert(primes.end(), primePart[t].begin(), primePart[t].end());
+            }
+        }
+        cur.swap(next);
+    }
+
+    std::sort(primes.begin(), primes.end());
+    return primes;
+}
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef QM_ZDD_H
+#define QM_ZDD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "qm_primes.h"
+#include "qm_cover.h"
+
+/*** ================== Implicit prime generation (BDD + ZDD) ================== ***/
+// Coudert–Madre 式的隱式做法：函數用 BDD 表示，cube 集合用 ZDD 表示，
+// prime 集合直接由 BDD 遞迴算出，不需要一層一層列舉 cube。
+//   Prime(f) = Prime(f0·f1) ∪ x'·(Prime(f0) \ Prime(f0·f1)) ∪ x·(Prime(f1) \ Prime(f0·f1))
+// 變數順序：index 大的在上層（BDD 的兩個 cofactor 正好是 truth table 的前後兩半）。
+// ZDD 變數是 literal：x_i 正相 = 2i，反相 = 2i+1。
+// 所有節點共用一個 node arena，節點數超過 maxNodes 就設 overflow，之後的運算都直接回 0，
+// 呼叫端看 Overflow() 決定要不要改用 explicit QM。
+
+class QMZddManager {
+public:
+    explicit QMZddManager(size_t maxNodes) : maxNodes_(maxNodes) {
+        // 0 = false / 空集合，1 = true / {∅}
+        var_ = {-1, -1};
+        lo_ = {0, 1};
+        hi_ = {0, 1};
+        table_.assign(1 << 12, 0);
+        cache_.assign(1 << 12, CacheEntry());
+    }
+
+    bool Overflow() const { return overflow_; }
+    size_t NodeNum() const { return var_.size(); }
+    int Var(int n) const { return var_[n]; }
+    int Lo(int n) const { return lo_[n]; }
+    int Hi(int n) const { return hi_[n]; }
+
+    /*** ---------- BDD ---------- ***/
+
+    int BddFromTruth(const uint64_t* pTruth, int nVars) { return FromTruthRec(pTruth, nVars, 0); }
+
+    int BddNot(int a) {
+        if (overflow_) return 0;
+        if (a <= 1) return a ^ 1;
+        int r;
+        if (CacheLookup(OP_NOT, a, 0, r)) return r;
+        r = MkBdd(var_[a], BddNot(lo_[a]), BddNot(hi_[a]));
+        CacheInsert(OP_NOT, a, 0, r);
+        return r;
+    }
+
+    int BddAnd(int a, int b) {
+        if (overflow_) return 0;
+        if (a == 0 || b == 0) return 0;
+        if (a == 1 || a == b) return b;
+        if (b == 1) return a;
+        if (a > b) std::swap(a, b);
+        int r;
+        if (CacheLookup(OP_AND, a, b, r)) return r;
+        int v = std::max(var_[a], var_[b]);
+        r = MkBdd(v, BddAnd(Cof0(a, v), Cof0(b, v)), BddAnd(Cof1(a, v), Cof1(b, v)));
+        CacheInsert(OP_AND, a, b, r);
+        return r;
+    }
+
+    int BddOr(int a, int b) {
+        if (overflow_) return 0;
+        if (a == 1 || b == 1) return 1;
+        if (a == 0 || a == b) return b;
+        if (b == 0) return a;
+        if (a > b) std::swap(a, b);
+        int r;
+        if (CacheLookup(OP_OR, a, b, r)) return r;
+        int v = std::max(var_[a], var_[b]);
+        r = MkBdd(v, BddOr(Cof0(a, v), Cof0(b, v)), BddOr(Cof1(a, v), Cof1(b, v)));
+        CacheInsert(OP_OR, a, b, r);
+        return r;
+    }
+
+    /*** ---------- ZDD ---------- ***/
+
+    int ZddUnion(int a, int b) {
+        if (overflow_) return 0;
+        if (a == 0 || a == b) return b;
+        if (b == 0) return a;
+        if (a > b) std::swap(a, b);
+        int r;
+        if (CacheLookup(OP_UNION, a, b, r)) return r;
+        if (var_[a] > var_[b])
+            r = MkZdd(var_[a], ZddUnion(lo_[a], b), hi_[a]);
+        else if (var_[a] < var_[b])
+            r = MkZdd(var_[b], ZddUnion(a, lo_[b]), hi_[b]);
+        else
+            r = MkZdd(var_[a], ZddUnion(lo_[a], lo_[b]), ZddUnion(hi_[a], hi_[b]));
+        CacheInsert(OP_UNION, a, b, r);
+        return r;
+    }
+
+    int ZddDiff(int a, int b) {
+        if (overflow_) return 0;
+        if (a == 0 || a == b) return 0;
+        if (b == 0) return a;
+        int r;
+        if (CacheLookup(OP_DIFF, a, b, r)) return r;
+        if (var_[a] > var_[b])
+            r = MkZdd(var_[a], ZddDiff(lo_[a], b), hi_[a]);
+        else if (var_[a] < var_[b])
+            r = ZddDiff(a, lo_[b]);
+        else
+            r = MkZdd(var_[a], ZddDiff(lo_[a], lo_[b]), ZddDiff(hi_[a], hi_[b]));
+        CacheInsert(OP_DIFF, a, b, r);
+        return r;
+    }
+
+    double ZddCount(int a) {
+        std::unordered_map<int, double> memo;
+        return CountRec(a, memo);
+    }
+
+    /*** ---------- Prime / ISOP ---------- ***/
+
+    // f 的所有 prime implicant（ZDD）
+    int Primes(int f) {
+        if (overflow_) return 0;
+        if (f <= 1) return f;
+        int r;
+        if (CacheLookup(OP_PRIME, f, 0, r)) return r;
+        int v = var_[f];
+        int f0 = lo_[f], f1 = hi_[f];
+        int pDc = Primes(BddAnd(f0, f1));
+        int p0 = ZddDiff(Primes(f0), pDc);
+        int p1 = ZddDiff(Primes(f1), pDc);
+        r = MkZdd(2 * v + 1, MkZdd(2 * v, pDc, p1), p0);
+        CacheInsert(OP_PRIME, f, 0, r);
+        return r;
+    }
+
+    // Minato–Morreale ISOP：L ≤ cover ≤ U，回傳 cover 的 BDD，*pZdd = cover 的 cube 集合
+    int Isop(int L, int U, int* pZdd) {
+        *pZdd = 0;
+        if (overflow_ || L == 0) return 0;
+        if (U == 1) { *pZdd = 1; return 1; }
+        int rB, rZ;
+        if (CacheLookup(OP_ISOP_B, L, U, rB) && CacheLookup(OP_ISOP_Z, L, U, rZ)) {
+            *pZdd = rZ;
+            return rB;
+        }
+        int v = std::max(var_[L], var_[U]);
+        int L0 = Cof0(L, v), L1 = Cof1(L, v), U0 = Cof0(U, v), U1 = Cof1(U, v);
+        int z0, z1, zd;
+        int b0 = Isop(BddAnd(L0, BddNot(U1)), U0, &z0);
+        int b1 = Isop(BddAnd(L1, BddNot(U0)), U1, &z1);
+        int Ld = BddOr(BddAnd(L0, BddNot(b0)), BddAnd(L1, BddNot(b1)));
+        int bd = Isop(Ld, BddAnd(U0, U1), &zd);
+        rZ = MkZdd(2 * v + 1, MkZdd(2 * v, zd, z1), z0);
+        rB = MkBdd(v, BddOr(b0, bd), BddOr(b1, bd));
+        CacheInsert(OP_ISOP_B, L, U, rB);
+        CacheInsert(OP_ISOP_Z, L, U, rZ);
+        *pZdd = rZ;
+        return rB;
+    }
+
+private:
+    enum { OP_NOT = 1, OP_AND, OP_OR, OP_UNION, OP_DIFF, OP_PRIME, OP_ISOP_B, OP_ISOP_Z };
+
+    struct CacheEntry {
+        int op = 0, a = 0, b = 0, r = 0;
+    };
+
+    size_t maxNodes_;
+    bool overflow_ = false;
+    std::vector<int> var_, lo_, hi_;
+    std::vector<int> table_;        // unique table（open addressing，存 node id，0 = 空）
+    std::vector<CacheEntry> cache_; // 直接映射的 computed table，衝突時直接覆蓋，隨節點數長大
+    static const size_t kMaxCache = 1u << 22;
+
+    int Cof0(int a, int v) const { return var_[a] == v ? lo_[a] : a; }
+    int Cof1(int a, int v) const { return var_[a] == v ? hi_[a] : a; }
+
+    static size_t Hash3(uint32_t a, uint32_t b, uint32_t c) {
+        uint64_t k = ((uint64_t)a * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)b << 21) ^ ((uint64_t)c * 0xff51afd7ed558ccdULL);
+        k ^= k >> 29;
+        return (size_t)k;
+    }
+
+    bool CacheLookup(int op, int a, int b, int& r) const {
+        const CacheEntry& e = cache_[Hash3(op, a, b) & (cache_.size() - 1)];
+        if (e.op != op || e.a != a || e.b != b) return false;
+        r = e.r;
+        return true;
+    }
+    void CacheInsert(int op, int a, int b, int r) {
+        if (overflow_) return;
+        CacheEntry& e = cache_[Hash3(op, a, b) & (cache_.size() - 1)];
+        e.op = op; e.a = a; e.b = b; e.r = r;
+    }
+
+    int MkBdd(int v, int lo, int hi) { return lo == hi ? lo : MkNode(v, lo, hi); }
+    int MkZdd(int v, int lo, int hi) { return hi == 0 ? lo : MkNode(v, lo, hi); }
+
+    int MkNode(int v, int lo, int hi) {
+        if (overflow_) return 0;
+        size_t capMask = table_.size() - 1;
+        size_t h = Hash3(v, lo, hi) & capMask;
+        while (int n = table_[h]) {
+            if (var_[n] == v && lo_[n] == lo && hi_[n] == hi) return n;
+            h = (h + 1) & capMask;
+        }
+        if (var_.size() >= maxNodes_) {
+            overflow_ = true;
+            return 0;
+        }
+        int n = (int)var_.size();
+        var_.push_back(v);
+        lo_.push_back(lo);
+        hi_.push_back(hi);
+        table_[h] = n;
+        if (var_.size() * 2 > table_.size()) Rehash();
+        if (var_.size() > cache_.size() && cache_.size() < kMaxCache) cache_.assign(cache_.size() * 2, CacheEntry());
+        return n;
+    }
+
+    void Rehash() {
+        table_.assign(table_.size() * 2, 0);
+        size_t capMask = table_.size() - 1;
+        for (int n = 2; n < (int)var_.size(); ++n) {
+            size_t h = Hash3(var_[n], lo_[n], hi_[n]) & capMask;
+            while (table_[h]) h = (h + 1) & capMask;
+            table_[h] = n;
+        }
+    }
+
+    // minterm [base, base + 2^k) 這一段的 BDD，x_{k-1} 為頂層變數
+    int FromTruthRec(const uint64_t* pTruth, int k, uint64_t base) {
+        if (overflow_) return 0;
+        if (k <= 6) {
+            uint64_t full = (k == 6) ? ~0ULL : ((1ULL << (1u << k)) - 1);
+            uint64_t w = (pTruth[base >> 6] >> (base & 63)) & full;
+            if (w == 0) return 0;
+            if (w == full) return 1;
+        }
+        uint64_t half = 1ULL << (k - 1);
+        int lo = FromTruthRec(pTruth, k - 1, base);
+        int hi = FromTruthRec(pTruth, k - 1, base + half);
+        return MkBdd(k - 1, lo, hi);
+    }
+
+    double CountRec(int a, std::unordered_map<int, double>& memo) {
+        if (a <= 1) return a;
+        auto it = memo.find(a);
+        if (it != memo.end()) return it->second;
+        double c = CountRec(lo_[a], memo) + CountRec(hi_[a], memo);
+        memo.emplace(a, c);
+        return c;
+    }
+};
+
+/*** ================== ZDD cube ↔ Implicant ================== ***/
+
+inline void QM_ZddEnumRec(const QMZddManager& M, int z, int nVars, uint32_t bits, uint32_t mask,
+                          std::vector<Implicant>& out) {
+    if (z == 0) return;
+    if (z == 1) { out.push_back({bits, mask}); return; }
+    int lit = M.Var(z), v = lit >> 1;
+    uint32_t bit = 1u << v;
+    QM_ZddEnumRec(M, M.Lo(z), nVars, bits, mask, out);
+    QM_ZddEnumRec(M, M.Hi(z), nVars, (lit & 1) ? bits : (bits | bit), mask & ~bit, out);
+}
+
+// 在 prime 集合 P 裡找一個包含 cube 的 prime（literal ⊆ cube 的 literal），取 literal 最少者
+inline int QM_ZddBestPrimeRec(const QMZddManager& M, int z, const Implicant& cube,
+                              std::unordered_map<int, int>& memo) {
+    const int kInf = 1 << 20;
+    if (z == 0) return kInf;
+    if (z == 1) return 0;
+    auto it = memo.find(z);
+    if (it != memo.end()) return it->second;
+    int lit = M.Var(z), v = lit >> 1;
+    uint32_t bit = 1u << v;
+    bool inCube = !(cube.mask & bit) && (((cube.bits & bit) != 0) == !(lit & 1));
+    int best = QM_ZddBestPrimeRec(M, M.Lo(z), cube, memo);
+    if (inCube) best = std::min(best, 1 + QM_ZddBestPrimeRec(M, M.Hi(z), cube, memo));
+    memo.emplace(z, best);
+    return best;
+}
+
+inline Implicant QM_ZddExpandCube(const QMZddManager& M, int primes, const Implicant& cube, int nVars) {
+    std::unordered_map<int, int> memo;
+    QM_ZddBestPrimeRec(M, primes, cube, memo);
+    Implicant p = {0u, (nVars >= 32) ? ~0u : ((1u << nVars) - 1)};
+    int z = primes;
+    while (z > 1) {
+        int lit = M.Var(z), v = lit >> 1;
+        uint32_t bit = 1u << v;
+        bool inCube = !(cube.mask & bit) && (((cube.bits & bit) != 0) == !(lit & 1));
+        int viaLo = QM_ZddBestPrimeRec(M, M.Lo(z), cube, memo);
+        int viaHi = inCube ? 1 + QM_ZddBestPrimeRec(M, M.Hi(z), cube, memo) : (1 << 20);
+        if (viaHi < viaLo) {
+            p.mask &= ~bit;
+            if (!(lit & 1)) p.bits |= bit;
+            z = M.Hi(z);
+        } else {
+            z = M.Lo(z);
+        }
+    }
+    return p;
+}
+
+/*** ================== ZDD 模式的 minimization ================== ***/
+// 1. truth table → BDD → prime ZDD（節點數受 maxNodes 限制）
+// 2. prime 數 ≤ maxExplicitPrimes：全部展開，交給 QM_SolveCover（與 explicit 模式同樣的 exact cover）
+// 3. 否則不展開 prime 集合：用 ISOP 得到一組 irredundant cover，每個 cube 在 prime ZDD 中
+//    找包含它、literal 最少的 prime，再只對這些候選做 covering（去掉擴張後多餘的 cube）
+
+// covering 仍以 minterm 為 column（2^nVars 的對照表），所以變數數仍有上限
+static const int QM_ZDD_MAX_VARS = 24;
+
+struct QMZddParams {
+    size_t maxNodes = 1u << 22;           // BDD + ZDD 節點上限
+    double maxExplicitPrimes = 1 << 18;   // 超過就不展開 prime 集合
+};
+
+struct QMZddStats {
+    double nPrimes = 0;
+    size_t nNodes = 0;
+    int nCandidates = 0;
+    bool implicitCover = false;  // true = ISOP 導引的候選集合，false = 全部 prime
+};
+
+// 回傳 false = 超過節點上限，result 不可用
+inline bool QM_ZddMinimize(const uint64_t* pTruth, const std::vector<int>& onset, int nVars,
+                           const QMZddParams& zddParams, const QMCoverParams& coverParams,
+                           std::vector<Implicant>& result, QMCoverStats* pCoverStats = nullptr,
+                           QMZddStats* pStats = nullptr) {
+    result.clear();
+    QMZddStats stats;
+    if (onset.empty()) {
+        if (pStats) *pStats = stats;
+        return true;
+    }
+
+    QMZddManager M(zddParams.maxNodes);
+    int f = M.BddFromTruth(pTruth, nVars);
+    int primes = M.Primes(f);
+    if (M.Overflow()) return false;
+    stats.nPrimes = M.ZddCount(primes);
+
+    std::vector<Implicant> cands;
+    if (stats.nPrimes <= zddParams.maxExplicitPrimes) {
+        uint32_t full = (nVars >= 32) ? ~0u : ((1u << nVars) - 1);
+        QM_ZddEnumRec(M, primes, nVars, 0u, full, cands);
+    } else {
+        int isop = 0;
+        M.Isop(f, f, &isop);
+        if (M.Overflow()) return false;
+        std::vector<Implicant> cubes;
+        uint32_t full = (nVars >= 32) ? ~0u : ((1u << nVars) - 1);
+        QM_ZddEnumRec(M, isop, nVars, 0u, full, cubes);
+        for (const Implicant& c : cubes) cands.push_back(QM_ZddExpandCube(M, primes, c, nVars));
+        stats.implicitCover = true;
+    }
+    std::sort(cands.begin(), cands.end());
+    cands.erase(std::unique(cands.begin(), cands.end()), cands.end());
+    stats.nCandidates = (int)cands.size();
+    stats.nNodes = M.NodeNum();
+
+    result = QM_SolveCover(cands, onset, nVars, coverParams, pCoverStats);
+    if (pStats) *pStats = stats;
+    return true;
+}
+
+#endif
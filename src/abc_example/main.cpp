@@ -5,27 +5,12 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
 
 #include "base/abc/abc.h"
 #include "base/main/main.h"
 
-// 輔助函式：將二進位字串轉換為十六進位字串
-std::string BinToHex(const std::string& bin) {
-    std::string hex = "";
-    int len = bin.length();
-    // 補齊長度為 4 的倍數
-    int pad = (4 - (len % 4)) % 4;
-    std::string paddedBin = std::string(pad, '0') + bin;
-    
-    for (size_t i = 0; i < paddedBin.length(); i += 4) {
-        std::string chunk = paddedBin.substr(i, 4);
-        int val = std::stoi(chunk, nullptr, 2);
-        std::stringstream ss;
-        ss << std::hex << val;
-        hex += ss.str();
-    }
-    return hex;
-}
+#include "common/truth_table.h"
 
 int main(int argc, char * argv[]) {
     // 1. 初始化 ABC 框架
@@ -36,15 +21,24 @@ int main(int argc, char * argv[]) {
 
     // 2. 讀取檔案
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <truth_file>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <truth_file> [output=<j>]" << std::endl;
         Abc_Stop();
         return 1;
     }
     std::string filename = argv[1];
-    std::ifstream infile(filename);
-    
-    if (!infile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
+    int only = -1; // output=<j>：只合成第 j 個 output
+    if (argc > 2 && std::string(argv[2]).find("output=") == 0) only = std::atoi(argv[2] + 7);
+
+    // 一次只讀一個 output（.truth 只建行索引，.tbin 直接定位），其他 output 不會載入
+    TruthStream stream;
+    std::string err;
+    if (!stream.Open(filename, err)) {
+        std::cerr << "Error: " << err << std::endl;
+        Abc_Stop();
+        return 1;
+    }
+    if (only >= stream.NumOuts()) {
+        std::cerr << "Error: output " << only << " out of range (" << stream.NumOuts() << " outputs)" << std::endl;
         Abc_Stop();
         return 1;
     }
@@ -56,20 +50,20 @@ int main(int argc, char * argv[]) {
     size_t lastDot = stem.find_last_of(".");
     if (lastDot != std::string::npos) stem = stem.substr(0, lastDot);
 
-    std::string line;
-    int index = 0;
+    int first = only >= 0 ? only : 0;
+    int last = only >= 0 ? only + 1 : stream.NumOuts();
+    int nWritten = 0;
+    std::vector<uint64_t> words;
 
-    while (std::getline(infile, line)) {
-        // 移除空白字元
-        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
-        
-        // 跳過空行
-        if (line.empty()) continue;
-
-        std::cout << "Processing function #" << index << " (Length: " << line.length() << ")..." << std::endl;
+    for (int j = first; j < last; ++j) {
+        std::cout << "Processing function #" << j << " (Length: " << (1ULL << stream.NumVars()) << ")..." << std::endl;
+        if (!stream.Read(j, words, err)) {
+            std::cerr << "Error: " << err << std::endl;
+            continue;
+        }
 
         // 3. 轉換為 Hex 字串
-        std::string hexString = BinToHex(line);
+        std::string hexString = TruthToHex(words.data(), stream.NumVars());
 
         // 4. 執行 ABC 指令
         // 指令 1: read_truth
@@ -86,7 +80,7 @@ int main(int argc, char * argv[]) {
         }
 
         // 指令 3: write_aig (為每個函數產生獨立的檔案)
-        std::string outputFilename = "example/output/" + stem + "_" + std::to_string(index) + ".aig";
+        std::string outputFilename = "example/output/" + stem + "_" + std::to_string(j) + ".aig";
         std::string cmdWrite = "write_aiger " + outputFilename;
         if (Cmd_CommandExecute(pAbc, cmdWrite.c_str())) {
             std::cerr << "Cannot execute command: " << cmdWrite << std::endl;
@@ -94,12 +88,10 @@ int main(int argc, char * argv[]) {
         }
 
         std::cout << "Successfully wrote to " << outputFilename << std::endl;
-        index++;
+        nWritten++;
     }
-    
-    infile.close();
 
-    if (index == 0) {
+    if (nWritten == 0) {
         std::cerr << "Warning: No valid truth tables found in file." << std::endl;
     }
 
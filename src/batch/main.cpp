@@ -0,0 +1,395 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/truth_table.h"
+#include "common/aiger.h"
+
+// =========================================================
+// Batch scheduler (replaces the xargs loop in scripts/run_batch.sh)
+//
+// Usage: main <bench_dir> <result_dir> [options]
+//
+// Every case is one bin/orchestrator/main run per worker slot:
+//   - cases are ordered by an estimated cost (inputs, outputs, onset
+//     density) and the most expensive ones start first, so a 3 MB truth
+//     file never ends up as the last job of the batch
+//   - when no case is left to start, an idle slot steals a portfolio
+//     sub-job (the same case with another seed) from the most expensive
+//     case still running; it gets the time that case has left, and the
+//     smallest verified result of all sub-jobs is kept
+//   - each slot is pinned to one core, and every process it starts (the
+//     orchestrator, each eSLIM worker, the simplifier) gets its own
+//     address-space cap (RLIMIT_AS is per process, so a slot can use a
+//     few times mem_mb in total)
+// =========================================================
+
+const std::string ORCHESTRATOR_EXEC = "./bin/orchestrator/main";
+
+struct BatchConfig {
+    int nWorkers = 0;         // 0 = 所有可用核心
+    int timeLimit = 1800;     // 每個 case 的時間
+    int maxSubJobs = 4;       // 每個 case 最多同時幾個 sub-job（含主 job）
+    int minStealSecs = 60;    // case 剩下的時間少於此值就不再偷
+    long memLimitMb = 0;      // 每個行程的 address space 上限（RLIMIT_AS），0 = 不限
+    bool pin = true;
+    std::vector<int> caseIds;  // 空 = bench_dir 下所有 .truth
+};
+
+struct BatchCase {
+    std::string name;         // 例如 ex40
+    std::string input;
+    int nVars = 0;
+    int nOuts = 0;
+    double density = 0;       // onset 比例
+    double cost = 0;
+    // 執行狀態
+    int running = 0;
+    int nSubJobs = 0;
+    std::chrono::steady_clock::time_point start, deadline;
+    double seconds = 0;       // 開始到最後一個 sub-job 結束
+    int bestGates = -1;
+    std::string bestFile;
+};
+
+struct BatchSlot {
+    int core = -1;
+    pid_t pid = 0;
+    int caseIdx = -1;
+    int sub = 0;
+    std::string output;
+    std::chrono::steady_clock::time_point start, killAt;
+    bool termSent = false;
+};
+
+// =========================================================
+// Cost model
+// =========================================================
+// 真值表大小乘上 onset 的平衡程度：接近全 0 / 全 1 的 output 很快就收斂，
+// 一半一半的 output 才是 eSLIM / 簡化器真正要花時間的部分。
+static bool EstimateCase(BatchCase& c, std::string& err) {
+    TruthTable tt;
+    if (!LoadTruthFile(c.input, tt, err)) return false;
+    c.nVars = tt.nVars;
+    c.nOuts = tt.nOuts;
+    uint64_t ones = 0;
+    uint64_t mask = tt.nVars >= 6 ? ~0ULL : (1ULL << tt.nBits) - 1;
+    for (int j = 0; j < tt.nOuts; ++j) {
+        ones += TruthCountOnes(tt.Output(j), tt.nWords - 1);
+        ones += __builtin_popcountll(tt.Output(j)[tt.nWords - 1] & mask);
+    }
+    double bits = (double)tt.nBits * tt.nOuts;
+    c.density = ones / bits;
+    c.cost = bits * (0.1 + 4 * c.density * (1 - c.density));
+    return true;
+}
+
+// =========================================================
+// Process control
+// =========================================================
+
+static std::vector<int> AllowedCores() {
+    std::vector<int> cores;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET(i, &set)) cores.push_back(i);
+    if (cores.empty())
+        for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i) cores.push_back((int)i);
+    return cores;
+}
+
+// 子行程：自己的 process group（逾時時整組砍掉，包含 eSLIM worker），綁核心、限制記憶體、log 導到檔案
+static pid_t SpawnJob(const BatchConfig& config, const BatchSlot& slot, const std::vector<std::string>& args,
+                      const std::string& logFile) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+    setpgid(0, 0);
+    if (config.pin && slot.core >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(slot.core, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+    if (config.memLimitMb > 0) {
+        struct rlimit rl;
+        rl.rlim_cur = rl.rlim_max = (rlim_t)config.memLimitMb << 20;
+        setrlimit(RLIMIT_AS, &rl);
+    }
+    int fd = open(logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+    }
+    std::vector<char*> argv;
+    for (const std::string& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+    execv(argv[0], argv.data());
+    std::perror("execv");
+    _exit(127);
+}
+
+static int ParseCaseIds(const std::string& spec, std::vector<int>& ids) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t dash = item.find('-');
+        int lo = std::stoi(item.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+        for (int id = lo; id <= hi; ++id) ids.push_back(id);
+    }
+    return (int)ids.size();
+}
+
+// =========================================================
+// MAIN
+// =========================================================
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <bench_dir> <result_dir> [options]" << std::endl;
+        std::cerr << "Options (key=value):" << std::endl;
+        std::cerr << "  workers=<int>      Concurrent jobs (one core each), 0 = all cores (Default: 0)" << std::endl;
+        std::cerr << "  time_limit=<int>   Time budget per case in seconds (Default: 1800)" << std::endl;
+        std::cerr << "  cases=<list>       Case ids, e.g. 20-29,50-59,90-99 (Default: every .truth file)" << std::endl;
+        std::cerr << "  max_sub=<int>      Concurrent sub-jobs per case, 1 = no stealing (Default: 4)" << std::endl;
+        std::cerr << "  min_steal=<int>    Only steal from cases with at least this many seconds left (Default: 60)" << std::endl;
+        std::cerr << "  mem_mb=<int>       Address-space cap per process in MB, 0 = none (Default: 0)" << std::endl;
+        std::cerr << "  pin=<0|1>          Pin each worker to its own core (Default: 1)" << std::endl;
+        return 1;
+    }
+    std::string benchDir = argv[1];
+    std::string resultDir = argv[2];
+    BatchConfig config;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.find("workers=") == 0) config.nWorkers = std::stoi(arg.substr(8));
+            else if (arg.find("time_limit=") == 0) config.timeLimit = std::stoi(arg.substr(11));
+            else if (arg.find("cases=") == 0) ParseCaseIds(arg.substr(6), config.caseIds);
+            else if (arg.find("max_sub=") == 0) config.maxSubJobs = std::max(1, std::stoi(arg.substr(8)));
+            else if (arg.find("min_steal=") == 0) config.minStealSecs = std::stoi(arg.substr(10));
+            else if (arg.find("mem_mb=") == 0) config.memLimitMb = std::stol(arg.substr(7));
+            else if (arg.find("pin=") == 0) config.pin = std::stoi(arg.substr(4)) != 0;
+            else std::cerr << "[Warn] Unknown argument: " << arg << std::endl;
+        } catch (...) { std::cerr << "[Warn] Invalid argument ignored: " << arg << std::endl; }
+    }
+    if (access(ORCHESTRATOR_EXEC.c_str(), X_OK) != 0) {
+        std::cerr << "[Error] " << ORCHESTRATOR_EXEC << " not found. Run 'make' first." << std::endl;
+        return 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(resultDir, ec);
+
+    std::vector<int> cores = AllowedCores();
+    if (config.nWorkers <= 0) config.nWorkers = (int)cores.size();
+
+    // ==================== Cases ====================
+    std::vector<std::string> inputs;
+    if (!config.caseIds.empty()) {
+        for (int id : config.caseIds) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "ex%02d", id);
+            // 轉好的 .tbin（bin/truthconv/main）優先
+            std::string base = benchDir + "/" + name;
+            inputs.push_back(std::filesystem::exists(base + ".tbin") ? base + ".tbin" : base + ".truth");
+        }
+    } else {
+        for (const auto& entry : std::filesystem::directory_iterator(benchDir, ec)) {
+            std::filesystem::path path = entry.path();
+            if (path.extension() == ".tbin" ||
+                (path.extension() == ".truth" && !std::filesystem::exists(path.parent_path() / (path.stem().string() + ".tbin"))))
+                inputs.push_back(path.string());
+        }
+        std::sort(inputs.begin(), inputs.end());
+    }
+
+    std::vector<BatchCase> cases;
+    for (const std::string& input : inputs) {
+        BatchCase c;
+        c.input = input;
+        c.name = std::filesystem::path(input).stem().string();
+        if (!std::filesystem::exists(input)) {
+            std::cout << "[Skip] " << c.name << ": Input not found." << std::endl;
+            continue;
+        }
+        if (std::filesystem::exists(resultDir + "/" + c.name + ".aig")) {
+            std::cout << "[Skip] " << c.name << ": Result exists." << std::endl;
+            continue;
+        }
+        std::string err;
+        if (!EstimateCase(c, err)) {
+            std::cout << "[Skip] " << c.name << ": " << err << std::endl;
+            continue;
+        }
+        cases.push_back(c);
+    }
+    // 最貴的先跑（LPT）
+    std::stable_sort(cases.begin(), cases.end(), [](const BatchCase& a, const BatchCase& b) { return a.cost > b.cost; });
+
+    std::cout << "==========================================================" << std::endl;
+    std::cout << "Batch: " << cases.size() << " case(s), " << config.nWorkers << " worker(s)"
+              << (config.pin ? " pinned" : "") << ", " << config.timeLimit << "s per case";
+    if (config.memLimitMb > 0) std::cout << ", " << config.memLimitMb << " MB per process";
+    std::cout << std::endl;
+    for (const BatchCase& c : cases)
+        std::cout << "  " << std::left << std::setw(8) << c.name << std::right << " " << std::setw(2) << c.nVars
+                  << " in " << std::setw(4) << c.nOuts << " out  onset " << std::fixed << std::setprecision(2)
+                  << c.density << "  cost " << std::scientific << std::setprecision(2) << c.cost
+                  << std::defaultfloat << std::endl;
+    std::cout << "==========================================================" << std::endl;
+
+    // ==================== Scheduling loop ====================
+    auto batchStart = std::chrono::steady_clock::now();
+    std::vector<BatchSlot> slots(config.nWorkers);
+    for (int s = 0; s < config.nWorkers; ++s) slots[s].core = cores[s % cores.size()];
+    size_t nextCase = 0;
+    int nSteals = 0;
+
+    auto secondsLeft = [](const BatchCase& c) {
+        return (int)std::chrono::duration_cast<std::chrono::seconds>(c.deadline - std::chrono::steady_clock::now())
+            .count();
+    };
+
+    auto startJob = [&](BatchSlot& slot, int ci, int timeLimit) {
+        BatchCase& c = cases[ci];
+        int sub = c.nSubJobs++;
+        std::string tag = c.name + (sub ? ".s" + std::to_string(sub) : std::string(".s0"));
+        slot.caseIdx = ci;
+        slot.sub = sub;
+        slot.output = resultDir + "/" + tag + ".aig";
+        slot.start = std::chrono::steady_clock::now();
+        slot.killAt = slot.start + std::chrono::seconds(timeLimit + 30);  // orchestrator 自己會在時限內結束
+        slot.termSent = false;
+        std::remove(slot.output.c_str());
+        // 每個 sub-job 給不同的固定 seed：同一個 case 的 sub-job 才不會跑出同一個結果，batch 也能重現
+        std::vector<std::string> args = {ORCHESTRATOR_EXEC, c.input, slot.output, "time_limit=" + std::to_string(timeLimit),
+                                         "workers=1", "seed=" + std::to_string((sub + 1) * 1000)};
+        slot.pid = SpawnJob(config, slot, args, resultDir + "/" + tag + ".log");
+        if (slot.pid < 0) {
+            std::cerr << "[Error] fork failed for " << tag << std::endl;
+            slot.pid = 0;
+            slot.caseIdx = -1;
+            c.nSubJobs--;
+            return;
+        }
+        c.running++;
+        std::cout << ">>> [" << (sub ? "Steal" : "Start") << "] " << tag << " on core " << slot.core << " ("
+                  << timeLimit << "s)" << std::endl;
+    };
+
+    auto finishCase = [&](BatchCase& c) {
+        std::string final = resultDir + "/" + c.name + ".aig";
+        if (c.bestGates >= 0) {
+            std::rename(c.bestFile.c_str(), final.c_str());
+            std::cout << ">>> [Done]  " << c.name << ": " << c.bestGates << " AND gates (" << c.nSubJobs
+                      << " sub-job(s), " << (int)c.seconds << "s)" << std::endl;
+        } else {
+            std::cout << ">>> [Fail]  " << c.name << ": no verified result. See " << resultDir << "/" << c.name
+                      << ".s0.log" << std::endl;
+        }
+        // 沒被選中的 sub-job 結果
+        for (int sub = 0; sub < c.nSubJobs; ++sub) {
+            std::string f = resultDir + "/" + c.name + ".s" + std::to_string(sub) + ".aig";
+            if (f != c.bestFile) std::remove(f.c_str());
+        }
+    };
+
+    while (true) {
+        // 1. 回收結束的 job
+        int status = 0;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            for (BatchSlot& slot : slots) {
+                if (slot.pid != pid) continue;
+                BatchCase& c = cases[slot.caseIdx];
+                c.running--;
+                c.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - c.start).count();
+                AigerHeader hdr;
+                std::string err;
+                // orchestrator 只會寫出驗證過的結果
+                bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && AigerReadHeader(slot.output, hdr, err);
+                if (ok && (c.bestGates < 0 || (int)hdr.A < c.bestGates)) {
+                    c.bestGates = (int)hdr.A;
+                    c.bestFile = slot.output;
+                }
+                if (!ok)
+                    std::cout << ">>> [Fail]  " << c.name << ".s" << slot.sub << " exited with "
+                              << (WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)) << std::endl;
+                if (c.running == 0) finishCase(c);
+                slot.pid = 0;
+                slot.caseIdx = -1;
+            }
+        }
+
+        // 2. 逾時保護：SIGTERM，30 秒後 SIGKILL（整個 process group）
+        auto now = std::chrono::steady_clock::now();
+        for (BatchSlot& slot : slots) {
+            if (!slot.pid || now < slot.killAt) continue;
+            kill(-slot.pid, slot.termSent ? SIGKILL : SIGTERM);
+            if (!slot.termSent) {
+                slot.termSent = true;
+                slot.killAt = now + std::chrono::seconds(30);
+            }
+        }
+
+        // 3. 空的 slot：先開新的 case，沒有的話偷最貴的執行中 case 的 sub-job
+        for (BatchSlot& slot : slots) {
+            if (slot.pid) continue;
+            if (nextCase < cases.size()) {
+                BatchCase& c = cases[nextCase];
+                c.start = std::chrono::steady_clock::now();
+                c.deadline = c.start + std::chrono::seconds(config.timeLimit);
+                startJob(slot, (int)nextCase++, config.timeLimit);
+                continue;
+            }
+            int victim = -1;
+            for (int ci = 0; ci < (int)cases.size(); ++ci) {
+                const BatchCase& c = cases[ci];
+                if (!c.running || c.nSubJobs >= config.maxSubJobs || c.running >= config.maxSubJobs) continue;
+                if (secondsLeft(c) < config.minStealSecs) continue;
+                if (victim < 0 || c.cost / c.running > cases[victim].cost / cases[victim].running) victim = ci;
+            }
+            if (victim < 0) break;
+            nSteals++;
+            startJob(slot, victim, secondsLeft(cases[victim]));
+        }
+
+        bool busy = false;
+        for (const BatchSlot& slot : slots) busy = busy || slot.pid;
+        if (!busy && nextCase >= cases.size()) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    // ==================== Summary ====================
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+    int nDone = 0;
+    std::cout << "==========================================================" << std::endl;
+    for (const BatchCase& c : cases) {
+        if (c.bestGates >= 0) nDone++;
+        std::cout << "  " << std::left << std::setw(8) << c.name << std::right << " "
+                  << (c.bestGates >= 0 ? std::to_string(c.bestGates) + " AND" : std::string("FAILED")) << "  "
+                  << c.nSubJobs << " sub-job(s)  " << (int)c.seconds << "s" << std::endl;
+    }
+    std::cout << "Batch complete: " << nDone << "/" << cases.size() << " case(s), " << nSteals << " stolen sub-job(s), "
+              << (int)wall << "s wall-clock." << std::endl;
+    return nDone == (int)cases.size() ? 0 : 1;
+}
@@ -0,0 +1,637 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/aig_check.h"
+#include "common/aiger.h"
+#include "common/stage_timer.h"
+#include "common/truth_table.h"
+
+// =========================================================
+// Benchmark harness (replaces grepping results/*/*.log for "Final Result")
+//
+// Usage: main [options]
+//
+// Runs one driver (bin/<driver>/main) on the selected cases of
+// benchmarks/<year>, one case at a time so the timings do not disturb each
+// other, with a fixed seed and time budget.  For every case it records
+//   - wall time, CPU time (the driver and every process it waited for)
+//     and peak RSS of the whole run (wait4)
+//   - the same per stage (parse, build, abc, eslim, simplifier, verify, ...)
+//     from the $AIGMIN_STAGE_LOG lines the driver writes
+//     (common/stage_timer.h)
+//   - AND count and depth of the result, and whether it matches the input
+//     (exhaustive simulation, common/aig_check.h)
+// and writes everything as JSON (one line per case).  With baseline= the
+// results are compared with an earlier JSON file of this harness or with a
+// directory of <case>.aig files (e.g. results/2022/30min, gates and depth
+// only); more AND gates, or more time / memory beyond the tolerances, is
+// reported as a regression.  Depth is informational unless tol_depth= is
+// given.  A baseline only counts when it had the same time budget: a JSON
+// baseline must match driver, time_limit and seed, and a directory baseline
+// needs baseline_time= equal to time_limit (results/2022/30min: 1800).
+// =========================================================
+
+const double BENCH_TIME_SLACK = 0.5;   // 秒：短的 stage 不因為雜訊被標成變慢
+const long BENCH_RSS_SLACK_KB = 16384;
+const int BENCH_GRACE_SECS = 60;       // 超過 time_limit 這麼久還沒結束就 SIGTERM
+
+struct BenchDriver {
+    const char* name;
+    const char* args;    // {in} {out} {name} {time} {seed} 會被取代
+    const char* result;  // driver 寫出的 AIG
+};
+
+// 已知 driver 的預設參數；其他 driver 用 args= / result= 指定
+const BenchDriver BENCH_DRIVERS[] = {
+    {"orchestrator", "{in} {out} time_limit={time} seed={seed} workers=1 cache=off", "{out}"},
+    {"eslim", "{in} {out} time_limit={time} seed={seed} workers=1", "{out}"},
+    {"QM", "{in}", "QM/output/{name}_qm.aig"},
+};
+
+struct BenchConfig {
+    std::string driver = "orchestrator";
+    std::string args;
+    std::string result;
+    std::vector<std::pair<std::string, int>> cases;  // (year, id)
+    int timeLimit = 60;
+    unsigned seed = 1;         // 不可為 0：driver 把 seed=0 換成自己的預設值，JSON 記下的就不是實際用的 seed
+    std::string outFile;       // 預設 results/bench/<driver>.json
+    std::string baseline;      // 空 = 不比較
+    int baselineTime = 0;      // 目錄 baseline 的時間預算（秒），必須等於 timeLimit
+    double tolTime = 0.25;     // 時間可以比 baseline 多的比例
+    double tolRss = 0.25;
+    int tolGates = 0;          // AND 數可以比 baseline 多幾個
+    int tolDepth = -1;         // 深度可以比 baseline 多幾層，-1 = 不比較（只列出）
+};
+
+struct BenchStage {
+    double wall = 0;
+    double cpu = 0;
+    long rssKb = 0;
+    int count = 0;
+};
+
+using BenchStages = std::vector<std::pair<std::string, BenchStage>>;  // 依第一次出現的順序
+
+struct BenchResult {
+    std::string key;           // 例如 2022/ex01
+    std::string name;
+    std::string input;
+    std::string status = "ok"; // ok / failed / timeout / no_output / wrong
+    int exitCode = 0;
+    int ands = -1;
+    int depth = -1;
+    int equivalent = -1;       // -1 = 無法檢查（輸入太多）
+    double wall = -1;
+    double cpu = -1;
+    long rssKb = -1;
+    BenchStages stages;
+};
+
+// JSON baseline 開頭記錄的執行條件
+struct BenchBaselineRun {
+    std::string driver;
+    int timeLimit = -1;
+    long seed = -1;
+};
+
+struct BenchBaseline {
+    int ands = -1;
+    int depth = -1;
+    double wall = -1;
+    double cpu = -1;
+    long rssKb = -1;
+    BenchStages stages;
+};
+
+static BenchStage& StageOf(BenchStages& stages, const std::string& name) {
+    for (auto& s : stages)
+        if (s.first == name) return s.second;
+    stages.push_back({name, BenchStage()});
+    return stages.back().second;
+}
+
+// =========================================================
+// Cases and argument templates
+// =========================================================
+
+// 例如 2022/0-9,40,2025/100-104：沒有年份的項目沿用前一個
+static bool ParseCases(const std::string& spec, std::vector<std::pair<std::string, int>>& cases) {
+    std::stringstream ss(spec);
+    std::string item, year = "2022";
+    while (std::getline(ss, item, ',')) {
+        size_t slash = item.find('/');
+        if (slash != std::string::npos) {
+            year = item.substr(0, slash);
+            item = item.substr(slash + 1);
+        }
+        size_t dash = item.find('-');
+        int lo = std::stoi(item.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+        for (int id = lo; id <= hi; ++id) cases.push_back({year, id});
+    }
+    return !cases.empty();
+}
+
+static std::string Substitute(std::string s, const std::map<std::string, std::string>& vars) {
+    for (const auto& kv : vars) {
+        size_t pos;
+        while ((pos = s.find(kv.first)) != std::string::npos) s.replace(pos, kv.first.size(), kv.second);
+    }
+    return s;
+}
+
+static std::vector<std::string> SplitArgs(const std::string& s) {
+    std::vector<std::string> args;
+    std::stringstream ss(s);
+    std::string a;
+    while (ss >> a) args.push_back(a);
+    return args;
+}
+
+// =========================================================
+// Running one case
+// =========================================================
+
+// 子行程自己一個 process group（逾時整組砍掉，包含 eSLIM worker），log 導到檔案
+static pid_t SpawnDriver(const std::vector<std::string>& args, const std::string& logFile, const std::string& stageLog) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+    setpgid(0, 0);
+    setenv("AIGMIN_STAGE_LOG", stageLog.c_str(), 1);
+    int fd = open(logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+    }
+    std::vector<char*> argv;
+    for (const std::string& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+    execv(argv[0], argv.data());
+    std::perror("execv");
+    _exit(127);
+}
+
+// stage=<name> wall=<s> cpu=<s> rss_kb=<kB>（common/stage_timer.h），同名的 stage 加總
+static void ReadStageLog(const std::string& file, BenchStages& stages) {
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        char name[128];
+        double wall = 0, cpu = 0;
+        long rssKb = 0;
+        if (std::sscanf(line.c_str(), "stage=%127s wall=%lf cpu=%lf rss_kb=%ld", name, &wall, &cpu, &rssKb) != 4)
+            continue;
+        BenchStage& s = StageOf(stages, name);
+        s.wall += wall;
+        s.cpu += cpu;
+        s.rssKb = std::max(s.rssKb, rssKb);
+        s.count++;
+    }
+}
+
+static void RunCase(const BenchConfig& config, const std::string& artifactDir, BenchResult& r) {
+    std::string tag = artifactDir + "/" + r.key.substr(0, r.key.find('/')) + "_" + r.name;
+    std::map<std::string, std::string> vars = {{"{in}", r.input},
+                                               {"{out}", tag + ".aig"},
+                                               {"{name}", r.name},
+                                               {"{time}", std::to_string(config.timeLimit)},
+                                               {"{seed}", std::to_string(config.seed)}};
+    std::vector<std::string> args = SplitArgs(Substitute(config.args, vars));
+    args.insert(args.begin(), "./bin/" + config.driver + "/main");
+    std::string output = Substitute(config.result, vars);
+    std::string stageLog = tag + ".stages";
+    std::remove(output.c_str());
+    std::remove(stageLog.c_str());
+
+    auto start = std::chrono::steady_clock::now();
+    auto killAt = start + std::chrono::seconds(config.timeLimit + BENCH_GRACE_SECS);
+    bool termSent = false, timedOut = false;
+    pid_t pid = SpawnDriver(args, tag + ".log", stageLog);
+    if (pid < 0) {
+        r.status = "failed";
+        r.exitCode = -1;
+        return;
+    }
+    int status = 0;
+    struct rusage ru;
+    std::memset(&ru, 0, sizeof(ru));
+    while (wait4(pid, &status, WNOHANG, &ru) == 0) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= killAt) {
+            timedOut = true;
+            kill(-pid, termSent ? SIGKILL : SIGTERM);
+            termSent = true;
+            killAt = now + std::chrono::seconds(10);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    r.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    r.cpu = StageCpuSeconds(ru);
+    r.rssKb = ru.ru_maxrss;
+    r.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    ReadStageLog(stageLog, r.stages);
+
+    if (timedOut) r.status = "timeout";
+    else if (r.exitCode != 0) r.status = "failed";
+
+    AigGraph g;
+    std::string err;
+    if (!AigerRead(output, g, err)) {
+        if (r.status == "ok") r.status = "no_output";
+        return;
+    }
+    r.ands = g.AndNum();
+    r.depth = AigLevelNum(g);
+    TruthTable tt;
+    AigCheckResult res;
+    if (LoadTruthFile(r.input, tt, err) && AigCheckTruth(g, tt, res, err)) {
+        r.equivalent = res.equivalent ? 1 : 0;
+        if (!res.equivalent) r.status = "wrong";
+    }
+}
+
+// =========================================================
+// JSON
+// =========================================================
+
+static std::string JsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+static std::string JsonNumber(double x) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", x);
+    return buf;
+}
+
+static std::string JsonStages(const BenchStages& stages) {
+    std::string out = "{";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const BenchStage& s = stages[i].second;
+        if (i) out += ", ";
+        out += JsonString(stages[i].first) + ": {\"wall\": " + JsonNumber(s.wall) + ", \"cpu\": " + JsonNumber(s.cpu) +
+               ", \"rss_kb\": " + std::to_string(s.rssKb) + ", \"count\": " + std::to_string(s.count) + "}";
+    }
+    return out + "}";
+}
+
+// 一個 case 一行：欄位順序固定，頂層的數值都在 "stages" 之前（LoadJsonBaseline 靠這個）
+static std::string JsonCase(const BenchResult& r, const BenchBaseline* base, const std::vector<std::string>& regressions) {
+    std::string out = "{\"case\": " + JsonString(r.key) + ", \"input\": " + JsonString(r.input) +
+                      ", \"status\": " + JsonString(r.status) + ", \"exit\": " + std::to_string(r.exitCode) +
+                      ", \"equivalent\": " + (r.equivalent < 0 ? "null" : r.equivalent ? "true" : "false") +
+                      ", \"ands\": " + std::to_string(r.ands) + ", \"depth\": " + std::to_string(r.depth) +
+                      ", \"wall\": " + JsonNumber(r.wall) + ", \"cpu\": " + JsonNumber(r.cpu) +
+                      ", \"rss_kb\": " + std::to_string(r.rssKb) + ", \"stages\": " + JsonStages(r.stages);
+    if (base)
+        out += ", \"baseline\": {\"ands\": " + std::to_string(base->ands) + ", \"depth\": " + std::to_string(base->depth) +
+               ", \"wall\": " + JsonNumber(base->wall) + ", \"cpu\": " + JsonNumber(base->cpu) + "}";
+    out += ", \"regressions\": [";
+    for (size_t i = 0; i < regressions.size(); ++i) out += (i ? ", " : "") + JsonString(regressions[i]);
+    return out + "]}";
+}
+
+// =========================================================
+// Baseline
+// =========================================================
+
+// 在 s[from, to) 找 "key": 後面的數字
+static bool JsonFind(const std::string& s, const std::string& key, size_t from, size_t to, double& x) {
+    size_t pos = s.find("\"" + key + "\": ", from);
+    if (pos == std::string::npos || pos >= to) return false;
+    const char* p = s.c_str() + pos + key.size() + 4;
+    char* end = nullptr;
+    x = std::strtod(p, &end);
+    return end != p;
+}
+
+// 這個 harness 自己寫的 JSON：開頭是執行條件，之後一行一個 case
+static bool LoadJsonBaseline(const std::string& file, std::map<std::string, BenchBaseline>& base,
+                             BenchBaselineRun& run, std::string& err) {
+    std::ifstream in(file);
+    if (!in) {
+        err = "Cannot open " + file;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t pos = line.find("{\"case\": \"");
+        if (pos == std::string::npos) {
+            double x;
+            if (JsonFind(line, "time_limit", 0, line.size(), x)) run.timeLimit = (int)x;
+            if (JsonFind(line, "seed", 0, line.size(), x)) run.seed = (long)x;
+            size_t d = line.find("\"driver\": \"");
+            if (d != std::string::npos) run.driver = line.substr(d + 11, line.find('"', d + 11) - d - 11);
+            continue;
+        }
+        size_t keyStart = pos + 10;
+        std::string key = line.substr(keyStart, line.find('"', keyStart) - keyStart);
+        size_t stagesPos = line.find("\"stages\": {", keyStart);
+        if (stagesPos == std::string::npos) continue;
+        BenchBaseline b;
+        double x;
+        if (JsonFind(line, "ands", keyStart, stagesPos, x)) b.ands = (int)x;
+        if (JsonFind(line, "depth", keyStart, stagesPos, x)) b.depth = (int)x;
+        if (JsonFind(line, "wall", keyStart, stagesPos, x)) b.wall = x;
+        if (JsonFind(line, "cpu", keyStart, stagesPos, x)) b.cpu = x;
+        if (JsonFind(line, "rss_kb", keyStart, stagesPos, x)) b.rssKb = (long)x;
+        // "name": {"wall": .., "cpu": .., "rss_kb": .., "count": ..}，裡面沒有巢狀的括號
+        size_t p = stagesPos + 11;
+        while (true) {
+            size_t q = line.find_first_not_of(", ", p);
+            if (q == std::string::npos || line[q] != '"') break;
+            size_t nameEnd = line.find('"', q + 1);
+            size_t open = line.find('{', nameEnd);
+            size_t close = line.find('}', open);
+            if (nameEnd == std::string::npos || open == std::string::npos || close == std::string::npos) break;
+            BenchStage& s = StageOf(b.stages, line.substr(q + 1, nameEnd - q - 1));
+            if (JsonFind(line, "wall", open, close, x)) s.wall = x;
+            if (JsonFind(line, "cpu", open, close, x)) s.cpu = x;
+            if (JsonFind(line, "rss_kb", open, close, x)) s.rssKb = (long)x;
+            if (JsonFind(line, "count", open, close, x)) s.count = (int)x;
+            p = close + 1;
+        }
+        base[key] = b;
+    }
+    if (base.empty()) {
+        err = "No cases in " + file;
+        return false;
+    }
+    return true;
+}
+
+// <dir>/<name>.aig（例如 results/2022/30min）：只有 AND 數和深度
+static void LoadAigBaseline(const std::string& dir, const std::vector<BenchResult>& results,
+                            std::map<std::string, BenchBaseline>& base) {
+    for (const BenchResult& r : results) {
+        AigGraph g;
+        std::string err;
+        if (!AigerRead(dir + "/" + r.name + ".aig", g, err)) continue;
+        BenchBaseline b;
+        b.ands = g.AndNum();
+        b.depth = AigLevelNum(g);
+        base[r.key] = b;
+    }
+}
+
+static void Compare(const BenchConfig& config, const BenchResult& r, const BenchBaseline& b,
+                    std::vector<std::string>& regressions) {
+    auto slower = [&](double now, double before) {
+        return before >= 0 && now > before * (1 + config.tolTime) + BENCH_TIME_SLACK;
+    };
+    auto fmt = [](double x) {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2) << x;
+        return os.str();
+    };
+    if (r.ands >= 0 && b.ands >= 0 && r.ands > b.ands + config.tolGates)
+        regressions.push_back("ands " + std::to_string(r.ands) + " > " + std::to_string(b.ands));
+    if (config.tolDepth >= 0 && r.depth >= 0 && b.depth >= 0 && r.depth > b.depth + config.tolDepth)
+        regressions.push_back("depth " + std::to_string(r.depth) + " > " + std::to_string(b.depth));
+    if (slower(r.wall, b.wall)) regressions.push_back("wall " + fmt(r.wall) + "s > " + fmt(b.wall) + "s");
+    if (slower(r.cpu, b.cpu)) regressions.push_back("cpu " + fmt(r.cpu) + "s > " + fmt(b.cpu) + "s");
+    if (b.rssKb > 0 && r.rssKb > b.rssKb * (1 + config.tolRss) + BENCH_RSS_SLACK_KB)
+        regressions.push_back("rss " + std::to_string(r.rssKb) + " kB > " + std::to_string(b.rssKb) + " kB");
+    for (const auto& s : r.stages)
+        for (const auto& t : b.stages)
+            if (s.first == t.first && slower(s.second.cpu, t.second.cpu))
+                regressions.push_back(s.first + " cpu " + fmt(s.second.cpu) + "s > " + fmt(t.second.cpu) + "s");
+}
+
+static std::string CommandOutput(const char* cmd) {
+    std::string out;
+    if (FILE* p = popen(cmd, "r")) {
+        char buf[256];
+        while (std::fgets(buf, sizeof(buf), p)) out += buf;
+        pclose(p);
+    }
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+    return out;
+}
+
+// =========================================================
+// MAIN
+// =========================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    std::string caseSpec = "2022/0-9,2025/100-104";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.find("driver=") == 0) config.driver = arg.substr(7);
+            else if (arg.find("args=") == 0) config.args = arg.substr(5);
+            else if (arg.find("result=") == 0) config.result = arg.substr(7);
+            else if (arg.find("cases=") == 0) caseSpec = arg.substr(6);
+            else if (arg.find("time_limit=") == 0) config.timeLimit = std::stoi(arg.substr(11));
+            else if (arg.find("seed=") == 0) {
+                config.seed = (unsigned)std::stoul(arg.substr(5));
+                if (config.seed == 0) {
+                    std::cerr << "[Error] seed=0 makes the driver pick its default seed; pass a non-zero seed so the report records the one used." << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg.find("out=") == 0) config.outFile = arg.substr(4);
+            else if (arg.find("baseline=") == 0) config.baseline = arg.substr(9) == "off" ? "" : arg.substr(9);
+            else if (arg.find("tol_time=") == 0) config.tolTime = std::stod(arg.substr(9));
+            else if (arg.find("tol_rss=") == 0) config.tolRss = std::stod(arg.substr(8));
+            else if (arg.find("baseline_time=") == 0) config.baselineTime = std::stoi(arg.substr(14));
+            else if (arg.find("tol_gates=") == 0) config.tolGates = std::stoi(arg.substr(10));
+            else if (arg.find("tol_depth=") == 0) config.tolDepth = std::stoi(arg.substr(10));
+            else if (arg == "-h" || arg == "--help") {
+                std::cerr << "Usage: " << argv[0] << " [options]" << std::endl;
+                std::cerr << "Options (key=value):" << std::endl;
+                std::cerr << "  driver=<name>      bin/<name>/main to run (Default: orchestrator; presets: orchestrator, eslim, QM)" << std::endl;
+                std::cerr << "  args=<template>    Driver arguments, {in} {out} {name} {time} {seed} are substituted (Default: preset)" << std::endl;
+                std::cerr << "  result=<template>  AIG written by the driver (Default: preset, or {out})" << std::endl;
+                std::cerr << "  cases=<list>       <year>/<ids>, e.g. 2022/0-9,40,2025/100-104 (Default: 2022/0-9,2025/100-104)" << std::endl;
+                std::cerr << "  time_limit=<int>   Time budget per case in seconds (Default: 60)" << std::endl;
+                std::cerr << "  seed=<int>         Non-zero seed handed to the driver (Default: 1)" << std::endl;
+                std::cerr << "  out=<file.json>    Results (Default: results/bench/<driver>.json, artifacts next to it)" << std::endl;
+                std::cerr << "  baseline=<file.json|dir|off> Earlier results with the same driver, time_limit and seed, or a directory of <case>.aig (Default: off)" << std::endl;
+                std::cerr << "  baseline_time=<int> Time budget the <case>.aig directory was made with, must equal time_limit (e.g. 1800 for results/2022/30min)" << std::endl;
+                std::cerr << "  tol_time=<float>   Allowed slowdown of total / per-stage time (Default: 0.25)" << std::endl;
+                std::cerr << "  tol_rss=<float>    Allowed growth of peak RSS (Default: 0.25)" << std::endl;
+                std::cerr << "  tol_gates=<int>    Allowed extra AND gates (Default: 0)" << std::endl;
+                std::cerr << "  tol_depth=<int>    Allowed extra levels, -1 = depth is informational only (Default: -1)" << std::endl;
+                std::cerr << "Exit status: 0 = no regression, 1 = a case failed, 2 = regression." << std::endl;
+                return 1;
+            }
+            else std::cerr << "[Warn] Unknown argument: " << arg << std::endl;
+        } catch (...) { std::cerr << "[Warn] Invalid argument ignored: " << arg << std::endl; }
+    }
+    for (const BenchDriver& d : BENCH_DRIVERS) {
+        if (config.driver != d.name) continue;
+        if (config.args.empty()) config.args = d.args;
+        if (config.result.empty()) config.result = d.result;
+    }
+    if (config.args.empty()) {
+        std::cerr << "[Error] No argument preset for driver '" << config.driver << "'; pass args=<template>." << std::endl;
+        return 1;
+    }
+    if (config.result.empty()) config.result = "{out}";
+    std::string exe = "./bin/" + config.driver + "/main";
+    if (access(exe.c_str(), X_OK) != 0) {
+        std::cerr << "[Error] " << exe << " not found. Run 'make' first." << std::endl;
+        return 1;
+    }
+    try {
+        if (!ParseCases(caseSpec, config.cases)) throw 0;
+    } catch (...) {
+        std::cerr << "[Error] Invalid cases: " << caseSpec << std::endl;
+        return 1;
+    }
+    if (config.outFile.empty()) config.outFile = "results/bench/" + config.driver + ".json";
+    std::filesystem::path outPath(config.outFile);
+    std::string artifactDir = (outPath.parent_path() / outPath.stem()).string();
+    std::error_code ec;
+    std::filesystem::create_directories(artifactDir, ec);
+
+    // ==================== Cases ====================
+    std::vector<BenchResult> results;
+    for (const auto& c : config.cases) {
+        BenchResult r;
+        char name[32];
+        std::snprintf(name, sizeof(name), "ex%02d", c.second);
+        r.name = name;
+        r.key = c.first + "/" + r.name;
+        // 轉好的 .tbin（bin/truthconv/main）優先
+        std::string base = "benchmarks/" + c.first + "/" + r.name;
+        r.input = std::filesystem::exists(base + ".tbin") ? base + ".tbin" : base + ".truth";
+        if (!std::filesystem::exists(r.input)) {
+            std::cout << "[Skip] " << r.key << ": Input not found." << std::endl;
+            continue;
+        }
+        results.push_back(r);
+    }
+
+    // baseline 先讀：out= 可以和 baseline= 是同一個檔案
+    // 時間預算不同的 baseline（例如 60 秒對 30 分鐘的 results/2022/30min）比出來的全是雜訊，直接拒絕
+    std::map<std::string, BenchBaseline> baseline;
+    if (!config.baseline.empty()) {
+        std::string err;
+        BenchBaselineRun run;
+        if (std::filesystem::is_directory(config.baseline, ec)) {
+            if (config.baselineTime != config.timeLimit) {
+                std::cerr << "[Error] baseline=" << config.baseline << " needs baseline_time=<s> equal to time_limit="
+                          << config.timeLimit << " (got " << config.baselineTime << ")." << std::endl;
+                return 1;
+            }
+            LoadAigBaseline(config.baseline, results, baseline);
+        }
+        else if (!LoadJsonBaseline(config.baseline, baseline, run, err))
+            std::cerr << "[Baseline] " << err << " (no comparison)" << std::endl;
+        else if (run.driver != config.driver || run.timeLimit != config.timeLimit || run.seed != (long)config.seed) {
+            std::cerr << "[Error] Baseline " << config.baseline << " was run with driver=" << run.driver
+                      << " time_limit=" << run.timeLimit << " seed=" << run.seed << "; this run uses driver="
+                      << config.driver << " time_limit=" << config.timeLimit << " seed=" << config.seed << "."
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "==========================================================" << std::endl;
+    std::cout << "Bench: " << exe << " " << config.args << std::endl;
+    std::cout << "       " << results.size() << " case(s), " << config.timeLimit << "s, seed " << config.seed
+              << ", baseline " << (config.baseline.empty() ? "off" : config.baseline) << " (" << baseline.size()
+              << " case(s))" << std::endl;
+    std::cout << "==========================================================" << std::endl;
+
+    // ==================== Runs ====================
+    std::vector<std::string> lines;
+    int nFailed = 0, nRegressed = 0;
+    long totalAnds = 0;
+    for (BenchResult& r : results) {
+        std::cout << ">>> [Run]   " << r.key << " ..." << std::flush;
+        RunCase(config, artifactDir, r);
+        auto it = baseline.find(r.key);
+        const BenchBaseline* base = it == baseline.end() ? nullptr : &it->second;
+        std::vector<std::string> regressions;
+        if (base) Compare(config, r, *base, regressions);
+        if (r.status != "ok") nFailed++;
+        if (!regressions.empty()) nRegressed++;
+        if (r.ands >= 0) totalAnds += r.ands;
+
+        std::cout << " " << r.status << ": " << r.ands << " AND, depth " << r.depth << ", " << std::fixed
+                  << std::setprecision(2) << r.wall << "s wall, " << r.cpu << "s cpu, " << r.rssKb / 1024
+                  << " MB" << std::defaultfloat;
+        if (base && base->ands >= 0) std::cout << " (baseline " << base->ands << ")";
+        std::cout << std::endl;
+        for (const auto& s : r.stages)
+            std::cout << "      " << std::left << std::setw(12) << s.first << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(9) << s.second.wall << "s wall " << std::setw(9)
+                      << s.second.cpu << "s cpu " << std::setw(7) << s.second.rssKb / 1024 << " MB  x"
+                      << s.second.count << std::defaultfloat << std::endl;
+        for (const std::string& reg : regressions) std::cout << "      [REGRESSION] " << reg << std::endl;
+        lines.push_back(JsonCase(r, base, regressions));
+    }
+
+    // ==================== JSON ====================
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    char date[32] = "";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    std::string tmp = config.outFile + ".tmp";
+    {
+        std::ofstream out(tmp);
+        out << "{" << std::endl;
+        out << "  \"driver\": " << JsonString(config.driver) << ", \"args\": " << JsonString(config.args)
+            << ", \"time_limit\": " << config.timeLimit << ", \"seed\": " << config.seed << "," << std::endl;
+        out << "  \"commit\": " << JsonString(CommandOutput("git rev-parse --short HEAD 2>/dev/null"))
+            << ", \"host\": " << JsonString(host) << ", \"cores\": " << std::thread::hardware_concurrency()
+            << ", \"date\": " << JsonString(date) << ", \"baseline\": " << JsonString(config.baseline) << ","
+            << std::endl;
+        out << "  \"cases\": [" << std::endl;
+        for (size_t i = 0; i < lines.size(); ++i)
+            out << "    " << lines[i] << (i + 1 < lines.size() ? "," : "") << std::endl;
+        out << "  ]," << std::endl;
+        out << "  \"summary\": {\"cases\": " << results.size() << ", \"failed\": " << nFailed
+            << ", \"regressed\": " << nRegressed << ", \"ands\": " << totalAnds << "}" << std::endl;
+        out << "}" << std::endl;
+        if (!out) {
+            std::cerr << "[Error] Cannot write " << tmp << std::endl;
+            return 1;
+        }
+    }
+    std::rename(tmp.c_str(), config.outFile.c_str());
+
+    std::cout << "==========================================================" << std::endl;
+    std::cout << "Bench complete: " << results.size() << " case(s), " << nFailed << " failed, " << nRegressed
+              << " regressed, " << totalAnds << " AND gates in total." << std::endl;
+    std::cout << "Results: " << config.outFile << " (logs in " << artifactDir << "/)" << std::endl;
+    if (nFailed) return 1;
+    return nRegressed ? 2 : 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+
+// ABC Headers
+#include "base/abc/abc.h"
+#include "base/main/main.h"
+
+#include "common/truth_table.h"
+#include "common/abc_aig.h"
+#include "common/aig_check.h"
+#include "common/aiger.h"
+
+// =========================================================
+// Equivalence checker (replaces the ABC call in scripts/check_aig.sh)
+//
+// Usage: main <spec.truth|golden.aig> <candidate.aig>
+//
+// A .truth / .tbin spec, or a golden AIG with at most AIG_CHECK_MAX_VARS inputs, is
+// checked by exhaustive simulation (common/aig_check.h); wider golden AIGs
+// fall back to ABC's miter + SAT.  Exit code 0 = equivalent, 1 = not
+// equivalent or error.
+// =========================================================
+
+static std::string MintermBits(uint64_t m, int nVars) {
+    // x_{n-1} ... x_0，與 .truth 的 MSB-first 順序一致
+    std::string s;
+    for (int i = nVars - 1; i >= 0; --i) s += ((m >> i) & 1) ? '1' : '0';
+    return s;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <spec.truth|spec.tbin|golden.aig> <candidate.aig>" << std::endl;
+        return 1;
+    }
+    std::string specFile = argv[1];
+    std::string candFile = argv[2];
+
+    AigGraph cand;
+    std::string err;
+    if (!AigerRead(candFile, cand, err)) {
+        std::cerr << "[Check] " << err << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    AigCheckResult res;
+    bool decided = false;
+    bool abcStarted = false;
+    int nVars = 0;
+
+    if (TruthIsTableFile(specFile)) {
+        TruthTable tt;
+        if (!LoadTruthFile(specFile, tt, err)) {
+            std::cerr << "[Check] " << err << std::endl;
+            return 1;
+        }
+        nVars = tt.nVars;
+        decided = AigCheckTruth(cand, tt, res, err);
+    } else {
+        AigGraph golden;
+        if (!AigerRead(specFile, golden, err)) {
+            std::cerr << "[Check] " << err << std::endl;
+            return 1;
+        }
+        nVars = golden.nPis;
+        if (golden.nPis > AIG_CHECK_MAX_VARS) {
+            Abc_Start();
+            abcStarted = true;
+        }
+        decided = AigCheckEquivalent(golden, cand, res, err);
+    }
+    if (abcStarted) Abc_Stop();
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    if (!decided) {
+        std::cerr << "[Check] " << err << std::endl;
+        return 1;
+    }
+    if (res.equivalent) {
+        std::cout << "[Check] Equivalent. (" << res.method << ", " << ms << " ms)" << std::endl;
+        return 0;
+    }
+    std::cout << "[Check] Verification FAILED! (" << res.method << ")" << std::endl;
+    std::cout << "   " << res.reason;
+    if (res.output >= 0 && nVars > 0 && nVars <= 64) std::cout << " (x" << nVars - 1 << "..x0 = " << MintermBits(res.minterm, nVars) << ")";
+    std::cout << std::endl;
+    return 1;
+}
@@ -0,0 +1,244 @@
+#ifndef COMMON_ABC_AIG_H
+#define COMMON_ABC_AIG_H
+
+// =========================================================
+// In-process ABC helpers
+//
+// Converts between the ABC frame and AigGraph (common/aiger.h) without
+// going through files, and holds the truth-table synthesis script (one
+// representative per NPN class of outputs, common/truth_npn.h) shared
+// by bin/eslim/main and the orchestrator, and the SAT-based cec fallback
+// of the simulation checker (common/aig_check.h).  Abc_Start() must have
+// been called by the driver.
+// =========================================================
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base/abc/abc.h"
+#include "base/main/main.h"
+
+#include "common/aig_builder.h"
+#include "common/aig_check.h"
+#include "common/aiger.h"
+#include "common/stage_timer.h"
+#include "common/truth_npn.h"
+#include "common/truth_table.h"
+
+inline bool ExecAbcCmd(Abc_Frame_t* pAbc, const std::string& cmd) {
+    if (Cmd_CommandExecute(pAbc, cmd.c_str())) {
+        std::cerr << "Error: ABC command failed: " << cmd << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// =========================================================
+// Abc_Ntk_t -> AigGraph
+// =========================================================
+// 正規化（strash）之後直接從記憶體中的 network 取出 AIG，不必先 write_aiger 再讀回來。
+// 節點依 DFS 順序編號，與 write_aiger 的 AND 順序一樣是拓撲順序。
+
+inline bool AbcNtkToAigGraph(Abc_Ntk_t* pNtk, AigGraph& aig, std::string& err) {
+    if (!pNtk || !Abc_NtkIsStrash(pNtk)) {
+        err = "Error: Current ABC network is not a strashed AIG";
+        return false;
+    }
+    aig = AigGraph();
+    aig.nPis = Abc_NtkPiNum(pNtk);
+    std::vector<unsigned> lit(Abc_NtkObjNumMax(pNtk), 0);
+    lit[Abc_ObjId(Abc_AigConst1(pNtk))] = 1;
+
+    Abc_Obj_t* pObj;
+    int i;
+    Abc_NtkForEachPi(pNtk, pObj, i) lit[Abc_ObjId(pObj)] = 2u * (i + 1);
+
+    Vec_Ptr_t* vNodes = Abc_NtkDfs(pNtk, 0);
+    Vec_PtrForEachEntry(Abc_Obj_t*, vNodes, pObj, i) {
+        unsigned f0 = lit[Abc_ObjFaninId0(pObj)] ^ (unsigned)Abc_ObjFaninC0(pObj);
+        unsigned f1 = lit[Abc_ObjFaninId1(pObj)] ^ (unsigned)Abc_ObjFaninC1(pObj);
+        lit[Abc_ObjId(pObj)] = aig.AndLit(aig.AndNum());
+        aig.fanin0.push_back(std::max(f0, f1));
+        aig.fanin1.push_back(std::min(f0, f1));
+    }
+    Vec_PtrFree(vNodes);
+
+    Abc_NtkForEachPo(pNtk, pObj, i)
+        aig.outputs.push_back(lit[Abc_ObjFaninId0(pObj)] ^ (unsigned)Abc_ObjFaninC0(pObj));
+    return true;
+}
+
+// =========================================================
+// AigGraph -> Abc_Ntk_t
+// =========================================================
+// 建出 strashed network（PI / PO 用 ABC 的預設名稱），呼叫端負責 Abc_NtkDelete。
+
+inline Abc_Ntk_t* AbcNtkFromAigGraph(const AigGraph& aig) {
+    Abc_Ntk_t* pNtk = Abc_NtkAlloc(ABC_NTK_STRASH, ABC_FUNC_AIG, 1);
+    std::vector<Abc_Obj_t*> obj(aig.MaxVar() + 1, nullptr);
+    obj[0] = Abc_ObjNot(Abc_AigConst1(pNtk));
+    for (int i = 0; i < aig.nPis; ++i) obj[1 + i] = Abc_NtkCreatePi(pNtk);
+    auto lit = [&](unsigned l) { return Abc_ObjNotCond(obj[l >> 1], (int)(l & 1)); };
+    for (int k = 0; k < aig.AndNum(); ++k)
+        obj[aig.AndLit(k) >> 1] = Abc_AigAnd((Abc_Aig_t*)pNtk->pManFunc, lit(aig.fanin0[k]), lit(aig.fanin1[k]));
+    for (unsigned l : aig.outputs) Abc_ObjAddFanin(Abc_NtkCreatePo(pNtk), lit(l));
+    Abc_NtkAddDummyPiNames(pNtk);
+    Abc_NtkAddDummyPoNames(pNtk);
+    return pNtk;
+}
+
+// =========================================================
+// Equivalence checking
+// =========================================================
+
+// miter + SAT（nConfLimit = 0 表示不限）；無法判定時回傳 false
+inline bool AbcCecAigs(const AigGraph& ref, const AigGraph& g, AigCheckResult& res, std::string& err,
+                       int nConfLimit = 0) {
+    res = AigCheckResult();
+    res.method = "cec";
+    if (ref.nLatches || g.nLatches) {
+        err = "Error: sequential AIGs are not supported";
+        return false;
+    }
+    if (!AigCheckInterface(g, ref.nPis, (int)ref.outputs.size(), res)) return true;
+
+    Abc_Ntk_t* pRef = AbcNtkFromAigGraph(ref);
+    Abc_Ntk_t* pCand = AbcNtkFromAigGraph(g);
+    Abc_Ntk_t* pMiter = Abc_NtkMiter(pRef, pCand, 1, 0, 0, 0);
+    Abc_NtkDelete(pRef);
+    Abc_NtkDelete(pCand);
+    if (!pMiter) {
+        err = "Error: Could not build the miter";
+        return false;
+    }
+    // 1 = UNSAT（等價），0 = SAT，-1 = 未定
+    int status = Abc_NtkMiterIsConstant(pMiter);
+    if (status == 0) status = 1;
+    else if (status == 1) status = 0;
+    else status = Abc_NtkMiterSat(pMiter, (ABC_INT64_T)nConfLimit, (ABC_INT64_T)0, 0, NULL, NULL);
+
+    bool decided = status != -1;
+    if (status == 1) {
+        res.equivalent = true;
+    } else if (status == 0) {
+        res.equivalent = false;
+        res.reason = "miter is satisfiable";
+        // 反例：把 SAT 的 model 當成輸入，找出不一致的 output
+        if (pMiter->pModel && ref.nPis <= 64) {
+            uint64_t m = 0;
+            for (int i = 0; i < ref.nPis; ++i)
+                if (pMiter->pModel[i]) m |= 1ULL << i;
+            auto eval = [&](const AigGraph& a, int j) {
+                std::vector<char> val(a.MaxVar() + 1, 0);
+                for (int i = 0; i < a.nPis; ++i) val[1 + i] = (m >> i) & 1;
+                auto lit = [&](unsigned l) { return val[l >> 1] ^ (char)(l & 1); };
+                for (int k = 0; k < a.AndNum(); ++k) val[a.AndLit(k) >> 1] = lit(a.fanin0[k]) & lit(a.fanin1[k]);
+                return lit(a.outputs[j]);
+            };
+            for (int j = 0; j < (int)ref.outputs.size(); ++j)
+                if (eval(ref, j) != eval(g, j)) {
+                    res.output = j;
+                    res.minterm = m;
+                    res.reason = "output " + std::to_string(j) + " differs at minterm " + std::to_string(m);
+                    break;
+                }
+        }
+    } else {
+        err = "Error: cec gave up (conflict limit)";
+    }
+    Abc_NtkDelete(pMiter);
+    return decided;
+}
+
+// 輸入夠少時用 exhaustive 模擬，否則退回 cec
+inline bool AigCheckEquivalent(const AigGraph& ref, const AigGraph& g, AigCheckResult& res, std::string& err) {
+    if (ref.nPis <= AIG_CHECK_MAX_VARS) return AigCheckAigs(ref, g, res, err);
+    return AbcCecAigs(ref, g, res, err);
+}
+
+// =========================================================
+// Truth table -> optimized AIG
+// =========================================================
+// TruthAigBuilder 建出初始 AIG，再跑一次 resyn2 風格的 script；結果留在 ABC frame 中，
+// 同時轉成 AigGraph 交給呼叫端。dedup 時另外只合成每個 NPN class 的代表（common/truth_npn.h），
+// 其他 output 由代表接線而成；接線的複本無法與其他 output 共用邏輯，所以保留兩者中較小的。
+
+inline bool AbcSynthesizeTruth(Abc_Frame_t* pAbc, const TruthTable& tt, AigGraph& aig, std::string& err,
+                               bool dedup = true) {
+    if (dedup) {
+        TruthNpnClasses npn;
+        TruthNpnClassify(tt, npn);
+        if (npn.Reduced()) {
+            std::cout << "[NPN] " << tt.nOuts << " outputs -> " << npn.nClasses << " classes." << std::endl;
+            TruthTable reps;
+            AigGraph repAig;
+            AigGraph expanded;
+            TruthNpnRepresentatives(tt, npn, reps);
+            if (!AbcSynthesizeTruth(pAbc, reps, repAig, err, false)) return false;
+            AigNpnExpand(repAig, npn, expanded);
+            if (!AbcSynthesizeTruth(pAbc, tt, aig, err, false)) return false;
+            std::cout << "[NPN] " << expanded.AndNum() << " AND gates from the representatives vs " << aig.AndNum()
+                      << " direct." << std::endl;
+            if (expanded.AndNum() < aig.AndNum()) {
+                aig = std::move(expanded);
+                Abc_FrameReplaceCurrentNetwork(pAbc, AbcNtkFromAigGraph(aig));
+            }
+            return true;
+        }
+    }
+    // Construct Network
+    Abc_Ntk_t * pNtk = Abc_NtkAlloc( ABC_NTK_STRASH, ABC_FUNC_AIG, 1 );
+    pNtk->pName = Extra_UtilStrsav( "multi_output_solution" );
+
+    int numInputs = tt.nVars;
+    std::cout << "[ABC] Constructing network: " << numInputs << " inputs, " << tt.nOuts << " outputs." << std::endl;
+
+    for (int i = 0; i < numInputs; i++) {
+        char name[10];
+        sprintf(name, "%c", 'a' + i);
+        Abc_NtkCreatePi( pNtk );
+        Abc_ObjAssignName( Abc_NtkPi(pNtk, i), name, NULL );
+    }
+
+    // Shannon/ISOP decomposition with cofactors shared across outputs
+    StageTimer buildStage("build");
+    auto buildStart = std::chrono::steady_clock::now();
+    TruthAigBuilder builder(pNtk);
+
+    for (int fIdx = 0; fIdx < tt.nOuts; fIdx++) {
+        Abc_Obj_t * pFinalNode = builder.Build(tt.Output(fIdx));
+
+        Abc_Obj_t * pPo = Abc_NtkCreatePo( pNtk );
+        Abc_ObjAddFanin( pPo, pFinalNode );
+
+        char outName[30];
+        if (tt.nOuts == 1) sprintf(outName, "F0");
+        else sprintf(outName, "f%d", fIdx);
+        Abc_ObjAssignName( pPo, outName, NULL );
+    }
+
+    auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart).count();
+    std::cout << "[ABC] Initial AIG: " << Abc_NtkNodeNum(pNtk) << " AND gates in " << buildMs << " ms ("
+              << builder.GetStats().nShannon << " Shannon nodes, " << builder.GetStats().nIsop << " SOP leaves, "
+              << builder.GetStats().nHits << " shared cofactors)." << std::endl;
+    buildStage.Stop();
+
+    Abc_FrameReplaceCurrentNetwork(pAbc, pNtk);
+
+    // Standard high-effort optimization script (resyn2)
+    StageTimer abcStage("abc");
+    Cmd_CommandExecute(pAbc, "strash");
+    Cmd_CommandExecute(pAbc, "balance");
+    Cmd_CommandExecute(pAbc, "rewrite -l");
+    Cmd_CommandExecute(pAbc, "balance");
+    Cmd_CommandExecute(pAbc, "rewrite -lz");
+    Cmd_CommandExecute(pAbc, "balance");
+    Cmd_CommandExecute(pAbc, "strash");
+
+    return AbcNtkToAigGraph(Abc_FrameReadNtk(pAbc), aig, err);
+}
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef COMMON_AIG_BUILDER_H
+#define COMMON_AIG_BUILDER_H
+
+// =========================================================
+// Truth table -> AIG builder
+//
+// Builds an output directly into a strashed Abc_Ntk_t from its packed truth
+// table (see truth_table.h).  Large functions are split by Shannon expansion
+// on the top variable; every sub-function is memoised by its truth table
+// (up to complement), so cofactors shared between outputs are built once.
+// Sub-functions of at most 6 variables fit in one word: for those an
+// irredundant SOP (Minato-Morreale ISOP) is used instead when it is cheaper.
+//
+// Variable i of the truth table is PI i of the network.
+// =========================================================
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "base/abc/abc.h"
+
+#include "common/truth_table.h"
+
+inline uint64_t Truth6Cof0(uint64_t t, int v) {
+    return (t & ~s_TruthVar6[v]) | ((t & ~s_TruthVar6[v]) << (1 << v));
+}
+inline uint64_t Truth6Cof1(uint64_t t, int v) {
+    return (t & s_TruthVar6[v]) | ((t & s_TruthVar6[v]) >> (1 << v));
+}
+inline bool Truth6HasVar(uint64_t t, int v) {
+    return Truth6Cof0(t, v) != Truth6Cof1(t, v);
+}
+
+// Repeats the low 2^nVars bits over the whole word (nVars < 6).
+inline uint64_t Truth6Stretch(uint64_t t, int nVars) {
+    for (int v = nVars; v < 6; ++v) t |= t << (1 << v);
+    return t;
+}
+
+class TruthAigBuilder {
+public:
+    struct Stats {
+        uint64_t nShannon = 0; // Shannon nodes created
+        uint64_t nIsop = 0;    // sub-functions built as SOP
+        uint64_t nHits = 0;    // memo hits
+    };
+
+    explicit TruthAigBuilder(Abc_Ntk_t* pNtk)
+        : pNtk_(pNtk), pMan_((Abc_Aig_t*)pNtk->pManFunc), nVars_(Abc_NtkPiNum(pNtk)),
+          cache_(nVars_ + 1) {}
+
+    // pTruth has TruthWordNum(nVars) words in the truth_table.h layout.
+    Abc_Obj_t* Build(const uint64_t* pTruth) {
+        std::vector<uint64_t> f(pTruth, pTruth + TruthWordNum(nVars_));
+        if (nVars_ < 6) f[0] = Truth6Stretch(f[0] & ((1ULL << (1 << nVars_)) - 1), nVars_);
+        return BuildRec(f.data(), nVars_);
+    }
+
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    struct Cube { uint8_t pos, neg; };
+
+    Abc_Ntk_t* pNtk_;
+    Abc_Aig_t* pMan_;
+    int nVars_;
+    std::vector<std::unordered_map<std::string, Abc_Obj_t*>> cache_; // per support size
+    Stats stats_;
+
+    Abc_Obj_t* Var(int v) { return Abc_NtkPi(pNtk_, v); }
+    Abc_Obj_t* Const0() { return Abc_ObjNot(Abc_AigConst1(pNtk_)); }
+
+    static bool IsConst0(const uint64_t* f, int n) {
+        for (int i = 0; i < n; ++i) if (f[i]) return false;
+        return true;
+    }
+    static bool IsConst1(const uint64_t* f, int n) {
+        for (int i = 0; i < n; ++i) if (~f[i]) return false;
+        return true;
+    }
+    static bool IsEqual(const uint64_t* a, const uint64_t* b, int n) {
+        for (int i = 0; i < n; ++i) if (a[i] != b[i]) return false;
+        return true;
+    }
+    static bool IsCompl(const uint64_t* a, const uint64_t* b, int n) {
+        for (int i = 0; i < n; ++i) if (a[i] != ~b[i]) return false;
+        return true;
+    }
+
+    // f is a function of x_0..x_{k-1}
+    Abc_Obj_t* BuildRec(const uint64_t* f, int k) {
+        int n = TruthWordNum(k);
+        if (IsConst0(f, n)) return Const0();
+        if (IsConst1(f, n)) return Abc_AigConst1(pNtk_);
+
+        // memo lookup on the phase with f(0) = 0
+        bool fCompl = f[0] & 1;
+        std::string key(n * sizeof(uint64_t), '\0');
+        uint64_t* pKey = reinterpret_cast<uint64_t*>(&key[0]);
+        for (int i = 0; i < n; ++i) pKey[i] = fCompl ? ~f[i] : f[i];
+        auto it = cache_[k].find(key);
+        if (it != cache_[k].end()) {
+            stats_.nHits++;
+            return Abc_ObjNotCond(it->second, fCompl);
+        }
+
+        Abc_Obj_t* pRes = (k <= 6) ? Build6(pKey[0], k) : BuildShannon(pKey, k);
+        cache_[k].emplace(std::move(key), pRes);
+        return Abc_ObjNotCond(pRes, fCompl);
+    }
+
+    Abc_Obj_t* BuildShannon(const uint64_t* f, int k) {
+        int n = TruthWordNum(k);
+        int v = k - 1;
+        // Cofactors of x_{k-1}; for k > 6 these are the two halves of f.
+        std::vector<uint64_t> c0, c1;
+        if (k > 6) {
+            c0.assign(f, f + n / 2);
+            c1.assign(f + n / 2, f + n);
+        } else {
+            c0.assign(1, Truth6Cof0(f[0], v));
+            c1.assign(1, Truth6Cof1(f[0], v));
+        }
+        int m = TruthWordNum(k - 1);
+        if (IsEqual(c0.data(), c1.data(), m)) return BuildRec(c0.data(), k - 1);
+
+        stats_.nShannon++;
+        Abc_Obj_t* x = Var(v);
+        if (IsConst0(c0.data(), m)) return Abc_AigAnd(pMan_, x, BuildRec(c1.data(), k - 1));
+        if (IsConst0(c1.data(), m)) return Abc_AigAnd(pMan_, Abc_ObjNot(x), BuildRec(c0.data(), k - 1));
+        if (IsConst1(c0.data(), m)) return Abc_AigOr(pMan_, Abc_ObjNot(x), BuildRec(c1.data(), k - 1));
+        if (IsConst1(c1.data(), m)) return Abc_AigOr(pMan_, x, BuildRec(c0.data(), k - 1));
+        if (IsCompl(c0.data(), c1.data(), m)) return Abc_AigXor(pMan_, x, BuildRec(c0.data(), k - 1));
+        Abc_Obj_t* p1 = BuildRec(c1.data(), k - 1);
+        Abc_Obj_t* p0 = BuildRec(c0.data(), k - 1);
+        return Abc_AigMux(pMan_, x, p1, p0);
+    }
+
+    // ---------- single-word functions ----------
+
+    Abc_Obj_t* Build6(uint64_t t, int k) {
+        std::vector<Cube> cover, coverN;
+        Isop6(t, t, k, cover);
+        Isop6(~t, ~t, k, coverN);
+        int costSop  = SopCost(cover);
+        int costSopN = SopCost(coverN);
+        std::unordered_set<uint64_t> seen;
+        int costShannon = ShannonCost6(t, k, seen);
+        if (std::min(costSop, costSopN) >= costShannon) {
+            uint64_t tk = t;
+            return BuildShannon(&tk, k);
+        }
+        stats_.nIsop++;
+        if (costSop <= costSopN) return BuildSop(cover);
+        return Abc_ObjNot(BuildSop(coverN));
+    }
+
+    // AND gates of a two-level SOP (cubes ANDed, then ORed)
+    static int SopCost(const std::vector<Cube>& cover) {
+        if (cover.empty()) return 0;
+        int cost = (int)cover.size() - 1;
+        for (const Cube& c : cover) {
+            int nLits = __builtin_popcount(c.pos) + __builtin_popcount(c.neg);
+            if (nLits > 1) cost += nLits - 1;
+        }
+        return cost;
+    }
+
+    // AND gates the Shannon expansion of t would need (sharing inside t only)
+    static int ShannonCost6(uint64_t t, int k, std::unordered_set<uint64_t>& seen) {
+        if (t == 0 || ~t == 0) return 0;
+        while (k > 0 && !Truth6HasVar(t, k - 1)) k--;
+        if (k == 0) return 0;
+        uint64_t key = (t & 1) ? ~t : t;
+        if (!seen.insert(key).second) return 0;
+        int v = k - 1;
+        uint64_t c0 = Truth6Cof0(t, v), c1 = Truth6Cof1(t, v);
+        bool triv0 = c0 == 0 || ~c0 == 0;
+        bool triv1 = c1 == 0 || ~c1 == 0;
+        int cost = ShannonCost6(c0, v, seen) + ShannonCost6(c1, v, seen);
+        if (triv0 && triv1) return cost; // t is a literal
+        if (triv0 || triv1) return cost + 1;
+        return cost + 3;
+    }
+
+    Abc_Obj_t* BuildSop(const std::vector<Cube>& cover) {
+        Abc_Obj_t* pSum = Const0();
+        for (const Cube& c : cover) {
+            Abc_Obj_t* pProd = Abc_AigConst1(pNtk_);
+            for (int v = 0; v < 6; ++v) {
+                if ((c.pos >> v) & 1) pProd = Abc_AigAnd(pMan_, pProd, Var(v));
+                if ((c.neg >> v) & 1) pProd = Abc_AigAnd(pMan_, pProd, Abc_ObjNot(Var(v)));
+            }
+            pSum = Abc_AigOr(pMan_, pSum, pProd);
+        }
+        return pSum;
+    }
+
+    // Minato-Morreale ISOP of the interval [uOn, uOnDc]; returns the cover's function.
+    static uint64_t Isop6(uint64_t uOn, uint64_t uOnDc, int nVars, std::vector<Cube>& cover) {
+        if (uOn == 0) return 0;
+        if (~uOnDc == 0) {
+            cover.push_back({0, 0});
+            return ~0ULL;
+        }
+        int v = nVars - 1;
+        for (; v >= 0; --v)
+            if (Truth6HasVar(uOn, v) || Truth6HasVar(uOnDc, v)) break;
+        uint64_t uOn0 = Truth6Cof0(uOn, v), uOn1 = Truth6Cof1(uOn, v);
+        uint64_t uDc0 = Truth6Cof0(uOnDc, v), uDc1 = Truth6Cof1(uOnDc, v);
+
+        size_t nBeg0 = cover.size();
+        uint64_t uRes0 = Isop6(uOn0 & ~uDc1, uDc0, v, cover);
+        size_t nBeg1 = cover.size();
+        uint64_t uRes1 = Isop6(uOn1 & ~uDc0, uDc1, v, cover);
+        size_t nBeg2 = cover.size();
+        uint64_t uRes2 = Isop6((uOn0 & ~uRes0) | (uOn1 & ~uRes1), uDc0 & uDc1, v, cover);
+
+        for (size_t i = nBeg0; i < nBeg1; ++i) cover[i].neg |= (uint8_t)(1 << v);
+        for (size_t i = nBeg1; i < nBeg2; ++i) cover[i].pos |= (uint8_t)(1 << v);
+        return uRes2 | (uRes0 & ~s_TruthVar6[v]) | (uRes1 & s_TruthVar6[v]);
+    }
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef COMMON_AIG_CHECK_H
+#define COMMON_AIG_CHECK_H
+
+// =========================================================
+// Exhaustive equivalence checking by simulation
+//
+// With at most AIG_CHECK_MAX_VARS inputs the whole input space is
+// simulated, 64 minterms per word, AIG_SIM_BLOCK words per node at a time
+// (AVX2 when available), in the packed layout of truth_table.h.  The
+// check is exact, and it stops at the first block that differs.  The
+// result names the first failing minterm (and the lowest output on it).
+//
+//   AigCheckTruth  candidate AIG vs the packed source truth table
+//   AigCheckAigs   two AIGs with the same interface
+//
+// Both return false only when the check cannot run (too many inputs);
+// the verdict is in AigCheckResult.  Wider circuits need SAT-based cec,
+// see AigCheckEquivalent in common/abc_aig.h.  No ABC dependency here.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/aiger.h"
+#include "common/truth_table.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+const int AIG_CHECK_MAX_VARS = 24;  // 2^24 minterms = 262144 words per node
+const int AIG_SIM_BLOCK = 64;       // 一次模擬的 word 數（4096 個 minterm）
+
+struct AigCheckResult {
+    bool equivalent = false;
+    int output = -1;         // 第一個不一致的 output（-1 = 介面不符或未知）
+    uint64_t minterm = 0;    // 不一致的最小 minterm（x_i = bit i）
+    std::string method;      // "exhaustive" / "cec"
+    std::string reason;      // 不等價時的說明
+};
+
+// =========================================================
+// Block simulator
+// =========================================================
+
+// o = (a ^ ca) & (b ^ cb)，ca / cb 為 0 或全 1
+inline void AigSimAnd(uint64_t* o, const uint64_t* a, uint64_t ca, const uint64_t* b, uint64_t cb) {
+#if defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi64x((long long)ca);
+    const __m256i vb = _mm256_set1_epi64x((long long)cb);
+    for (int w = 0; w < AIG_SIM_BLOCK; w += 4) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w)), va);
+        __m256i y = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w)), vb);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + w), _mm256_and_si256(x, y));
+    }
+#else
+    for (int w = 0; w < AIG_SIM_BLOCK; ++w) o[w] = (a[w] ^ ca) & (b[w] ^ cb);
+#endif
+}
+
+// 所有 AND 在一個 block（word w0 起的 AIG_SIM_BLOCK 個 word）上的值；val 以 var 為單位排列
+class AigBlockSim {
+public:
+    explicit AigBlockSim(const AigGraph& g) : g_(g), val_((size_t)(g.MaxVar() + 1) * AIG_SIM_BLOCK, 0) {}
+
+    void Run(uint64_t w0) {
+        for (int i = 0; i < g_.nPis; ++i) {
+            uint64_t* p = Var(1 + i);
+            if (i < 6) {
+                for (int w = 0; w < AIG_SIM_BLOCK; ++w) p[w] = s_TruthVar6[i];
+            } else {
+                for (int w = 0; w < AIG_SIM_BLOCK; ++w) p[w] = ((w0 + w) >> (i - 6)) & 1 ? ~0ULL : 0;
+            }
+        }
+        for (int k = 0; k < g_.AndNum(); ++k) {
+            unsigned f0 = g_.fanin0[k], f1 = g_.fanin1[k];
+            AigSimAnd(Var(g_.AndLit(k) >> 1), Var(f0 >> 1), (f0 & 1) ? ~0ULL : 0, Var(f1 >> 1),
+                      (f1 & 1) ? ~0ULL : 0);
+        }
+    }
+
+    // output j 在 block 內第 w 個 word 的值
+    uint64_t Output(int j, int w) const {
+        unsigned lit = g_.outputs[j];
+        uint64_t x = val_[(size_t)(lit >> 1) * AIG_SIM_BLOCK + w];
+        return (lit & 1) ? ~x : x;
+    }
+
+private:
+    const AigGraph& g_;
+    std::vector<uint64_t> val_;  // var 0（常數 0）永遠是 0
+
+    uint64_t* Var(unsigned v) { return val_.data() + (size_t)v * AIG_SIM_BLOCK; }
+};
+
+// =========================================================
+// Checks
+// =========================================================
+
+inline bool AigCheckInterface(const AigGraph& g, int nPis, int nOuts, AigCheckResult& res) {
+    if (g.nPis == nPis && (int)g.outputs.size() == nOuts && g.nLatches == 0) return true;
+    res.equivalent = false;
+    res.reason = "interface mismatch (" + std::to_string(g.nPis) + "/" + std::to_string(g.outputs.size()) +
+                 " vs " + std::to_string(nPis) + "/" + std::to_string(nOuts) + " inputs/outputs)";
+    return false;
+}
+
+// 依序比較每個 block；ref(j, word) 回傳參考值。第一個不一致的 word 中取最小的 minterm
+template <typename RefFn>
+inline void AigCheckExhaustive(const AigGraph& g, RefFn ref, AigCheckResult& res) {
+    res.method = "exhaustive";
+    uint64_t nWords = (uint64_t)TruthWordNum(g.nPis);
+    uint64_t mask = g.nPis >= 6 ? ~0ULL : (1ULL << (1u << g.nPis)) - 1;
+    int nOuts = (int)g.outputs.size();
+    AigBlockSim sim(g);
+    for (uint64_t w0 = 0; w0 < nWords; w0 += AIG_SIM_BLOCK) {
+        sim.Run(w0);
+        int nw = (int)std::min<uint64_t>(AIG_SIM_BLOCK, nWords - w0);
+        for (int w = 0; w < nw; ++w) {
+            int bestBit = 64;
+            for (int j = 0; j < nOuts; ++j) {
+                uint64_t diff = (sim.Output(j, w) ^ ref(j, w0 + w)) & mask;
+                if (!diff) continue;
+                int bit = __builtin_ctzll(diff);
+                if (bit < bestBit) {
+                    bestBit = bit;
+                    res.output = j;
+                }
+            }
+            if (bestBit < 64) {
+                res.equivalent = false;
+                res.minterm = (w0 + w) * 64 + (uint64_t)bestBit;
+                res.reason = "output " + std::to_string(res.output) + " differs at minterm " + std::to_string(res.minterm);
+                return;
+            }
+        }
+    }
+    res.equivalent = true;
+}
+
+inline bool AigCheckTruth(const AigGraph& g, const TruthTable& tt, AigCheckResult& res, std::string& err) {
+    res = AigCheckResult();
+    if (tt.nVars > AIG_CHECK_MAX_VARS) {
+        err = "Error: " + std::to_string(tt.nVars) + " inputs is too many for exhaustive simulation";
+        return false;
+    }
+    if (!AigCheckInterface(g, tt.nVars, tt.nOuts, res)) return true;
+    AigCheckExhaustive(g, [&](int j, uint64_t w) { return tt.Output(j)[w]; }, res);
+    return true;
+}
+
+inline bool AigCheckAigs(const AigGraph& ref, const AigGraph& g, AigCheckResult& res, std::string& err) {
+    res = AigCheckResult();
+    if (ref.nPis > AIG_CHECK_MAX_VARS) {
+        err = "Error: " + std::to_string(ref.nPis) + " inputs is too many for exhaustive simulation";
+        return false;
+    }
+    if (ref.nLatches) {
+        err = "Error: sequential AIGs are not supported";
+        return false;
+    }
+    if (!AigCheckInterface(g, ref.nPis, (int)ref.outputs.size(), res)) return true;
+    // 參考電路與候選一起逐 block 模擬
+    AigBlockSim refSim(ref);
+    uint64_t curBlock = ~0ULL;
+    AigCheckExhaustive(g, [&](int j, uint64_t w) {
+        uint64_t block = w / AIG_SIM_BLOCK * AIG_SIM_BLOCK;
+        if (block != curBlock) {
+            refSim.Run(block);
+            curBlock = block;
+        }
+        return refSim.Output(j, (int)(w - block));
+    }, res);
+    return true;
+}
+
+// 完整真值表（例如把 golden AIG 轉成規格）
+inline bool AigSimulateTruth(const AigGraph& g, TruthTable& tt, std::string& err) {
+    if (g.nPis > AIG_CHECK_MAX_VARS || g.nLatches) {
+        err = "Error: AIG is too wide (or sequential) for a truth table";
+        return false;
+    }
+    tt = TruthTable();
+    tt.nVars = g.nPis;
+    tt.nOuts = (int)g.outputs.size();
+    tt.nWords = TruthWordNum(g.nPis);
+    tt.nBits = 1ULL << g.nPis;
+    tt.words.assign((size_t)tt.nOuts * tt.nWords, 0);
+    uint64_t mask = g.nPis >= 6 ? ~0ULL : (1ULL << tt.nBits) - 1;
+    AigBlockSim sim(g);
+    for (int w0 = 0; w0 < tt.nWords; w0 += AIG_SIM_BLOCK) {
+        sim.Run((uint64_t)w0);
+        int nw = std::min(AIG_SIM_BLOCK, tt.nWords - w0);
+        for (int j = 0; j < tt.nOuts; ++j)
+            for (int w = 0; w < nw; ++w) tt.Output(j)[w0 + w] = sim.Output(j, w) & mask;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef COMMON_AIG_INCREMENTAL_H
+#define COMMON_AIG_INCREMENTAL_H
+
+// =========================================================
+// Incremental equivalence checking
+//
+// AigIncrementalVerifier keeps the last verified AIG and checks a new
+// version against it.  It only spends effort where the two versions
+// differ:
+//   1. Structural match: new AND nodes are hashed into the old AIG
+//      bottom-up.  A matched node computes exactly the old node's
+//      function.  An output that maps onto its old driver is unchanged.
+//   2. Signature filter: random-pattern signatures of the old nodes are
+//      cached.  Only the unmatched nodes under the changed outputs are
+//      simulated, so a wrong result is usually rejected here with a
+//      counter-example.
+//   3. Exact check on the changed region: matched nodes on the frontier
+//      become free inputs shared by both sides.  If both sides agree for
+//      every value of those inputs, they are equivalent.  Otherwise each
+//      changed output is rechecked on its full cone, exhaustively over
+//      its support (common/aig_check.h), or with the fallback (e.g. cec)
+//      when the support is too wide.
+// Commit() makes the checked AIG the new reference and reuses the
+// signatures of all matched nodes.  Apart from one hash lookup per node
+// for the match, the work grows with the changed region, not with the
+// circuit.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/aig_check.h"
+#include "common/aig_window.h"
+#include "common/aiger.h"
+
+const int AIG_SIG_WORDS = 16;  // 1024 個隨機 pattern
+
+struct AigIncrementalStats {
+    int nOutputs = 0;
+    int nChanged = 0;       // 結構上有改變的 output
+    int nMatched = 0;       // 對應到舊 AIG 的 AND
+    int nSimulated = 0;     // 為了 signature 重新模擬的 AND
+    int nCutLeaves = 0;     // 變動區域的邊界（PI + 對應到的節點）
+    int nFullCones = 0;     // 退回整個 cone 檢查的 output 數
+};
+
+class AigIncrementalVerifier {
+public:
+    using CheckFn = std::function<bool(const AigGraph&, const AigGraph&, AigCheckResult&, std::string&)>;
+
+    explicit AigIncrementalVerifier(uint64_t seed = 12345) : seed_(seed) {}
+
+    bool Valid() const { return valid_; }
+    const AigGraph& Reference() const { return ref_; }
+    const AigIncrementalStats& Stats() const { return stats_; }
+
+    // 新的參考電路（已知正確），所有 signature 重新計算
+    void Reset(const AigGraph& ref) {
+        ref_ = ref;
+        std::mt19937_64 rng(seed_);
+        pi_.assign((size_t)ref_.nPis * AIG_SIG_WORDS, 0);
+        for (uint64_t& w : pi_) w = rng();
+        sig_.assign((size_t)(ref_.MaxVar() + 1) * AIG_SIG_WORDS, 0);
+        for (int i = 0; i < ref_.nPis; ++i)
+            std::copy(pi_.begin() + (size_t)i * AIG_SIG_WORDS, pi_.begin() + (size_t)(i + 1) * AIG_SIG_WORDS,
+                      sig_.begin() + (size_t)(1 + i) * AIG_SIG_WORDS);
+        for (int k = 0; k < ref_.AndNum(); ++k)
+            SimAnd(&sig_[(size_t)(ref_.AndLit(k) >> 1) * AIG_SIG_WORDS], sig_, ref_.fanin0[k], ref_.fanin1[k]);
+        BuildTable();
+        valid_ = true;
+        checked_ = nullptr;
+    }
+
+    // g 與參考電路是否等價；無法判定時回傳 false（fallback 為空且 cone 太寬）
+    bool Check(const AigGraph& g, AigCheckResult& res, std::string& err, const CheckFn& fallback = nullptr) {
+        res = AigCheckResult();
+        res.method = "incremental";
+        stats_ = AigIncrementalStats();
+        checked_ = nullptr;
+        if (!valid_) {
+            err = "Error: incremental verifier has no reference";
+            return false;
+        }
+        if (!AigCheckInterface(g, ref_.nPis, (int)ref_.outputs.size(), res)) return true;
+        stats_.nOutputs = (int)g.outputs.size();
+
+        // 1. 結構對應
+        const unsigned kNone = ~0u;
+        map_.assign(g.MaxVar() + 1, kNone);
+        map_[0] = 0;
+        for (int i = 0; i < g.nPis; ++i) map_[1 + i] = 2u * (unsigned)(1 + i);
+        for (int k = 0; k < g.AndNum(); ++k) {
+            unsigned f0 = g.fanin0[k], f1 = g.fanin1[k];
+            unsigned m0 = map_[f0 >> 1], m1 = map_[f1 >> 1];
+            if (m0 == kNone || m1 == kNone) continue;
+            m0 ^= f0 & 1u;
+            m1 ^= f1 & 1u;
+            auto it = table_.find(Key(std::max(m0, m1), std::min(m0, m1)));
+            if (it == table_.end()) continue;
+            map_[g.AndLit(k) >> 1] = 2u * it->second;
+            stats_.nMatched++;
+        }
+        std::vector<int> changed;
+        for (int j = 0; j < (int)g.outputs.size(); ++j)
+            if (MapLit(g.outputs[j]) != ref_.outputs[j]) changed.push_back(j);
+        stats_.nChanged = (int)changed.size();
+        if (changed.empty()) {
+            res.equivalent = true;
+            checked_ = &g;
+            newSig_.clear();
+            return true;
+        }
+
+        // 2. signature：只模擬 changed output 之下沒有對應到的節點
+        std::vector<unsigned> newRoots, refRoots;
+        for (int j : changed) {
+            newRoots.push_back(g.outputs[j]);
+            refRoots.push_back(ref_.outputs[j]);
+        }
+        std::vector<unsigned> newLeaves, refLeaves;
+        std::vector<int> region, refRegion;
+        CutCollect(g, newRoots, [&](unsigned v) { return map_[v] != kNone; }, newLeaves, region);
+        newSig_.assign((size_t)(g.MaxVar() + 1) * AIG_SIG_WORDS, 0);
+        simulated_.assign(g.MaxVar() + 1, 0);
+        for (int k : region) {
+            unsigned v = g.AndLit(k) >> 1;
+            uint64_t* o = &newSig_[(size_t)v * AIG_SIG_WORDS];
+            const uint64_t* a = NewSig(g.fanin0[k] >> 1);
+            const uint64_t* b = NewSig(g.fanin1[k] >> 1);
+            uint64_t ca = (g.fanin0[k] & 1) ? ~0ULL : 0, cb = (g.fanin1[k] & 1) ? ~0ULL : 0;
+            for (int w = 0; w < AIG_SIG_WORDS; ++w) o[w] = (a[w] ^ ca) & (b[w] ^ cb);
+            simulated_[v] = 1;
+        }
+        stats_.nSimulated = (int)region.size();
+        for (int j : changed) {
+            const uint64_t* s = NewSig(g.outputs[j] >> 1);
+            const uint64_t* r = &sig_[(size_t)(ref_.outputs[j] >> 1) * AIG_SIG_WORDS];
+            uint64_t cs = (g.outputs[j] & 1) ? ~0ULL : 0, cr = (ref_.outputs[j] & 1) ? ~0ULL : 0;
+            for (int w = 0; w < AIG_SIG_WORDS; ++w) {
+                uint64_t diff = (s[w] ^ cs) ^ (r[w] ^ cr);
+                if (!diff) continue;
+                res.method = "signature";
+                res.equivalent = false;
+                res.output = j;
+                int bit = __builtin_ctzll(diff);
+                res.minterm = 0;
+                for (int i = 0; i < g.nPis && i < 64; ++i)
+                    if ((pi_[(size_t)i * AIG_SIG_WORDS + w] >> bit) & 1) res.minterm |= 1ULL << i;
+                res.reason = "output " + std::to_string(j) + " differs at minterm " + std::to_string(res.minterm);
+                return true;
+            }
+        }
+
+        // 3a. 變動區域：對應到的節點當成兩邊共用的自由輸入（以參考電路的 var 辨識）
+        {
+            std::vector<char> image(ref_.MaxVar() + 1, 0);
+            for (unsigned m : map_)
+                if (m != kNone) image[m >> 1] = 1;
+            CutCollect(ref_, refRoots, [&](unsigned v) { return image[v] != 0; }, refLeaves, refRegion);
+            std::unordered_map<unsigned, unsigned> leafLit;  // 參考電路的 var -> cut 的 PI literal
+            for (unsigned v : newLeaves) leafLit.emplace(map_[v] >> 1, 0);
+            for (unsigned v : refLeaves) leafLit.emplace(v, 0);
+            int nLeaves = 0;
+            for (auto& kv : leafLit) kv.second = 2u * (unsigned)(1 + nLeaves++);
+            stats_.nCutLeaves = nLeaves;
+            if (nLeaves <= AIG_CHECK_MAX_VARS) {
+                AigGraph newCut, refCut;
+                CutBuild(g, newRoots, region, [&](unsigned v) { return leafLit[map_[v] >> 1]; }, nLeaves, newCut);
+                CutBuild(ref_, refRoots, refRegion, [&](unsigned v) { return leafLit[v]; }, nLeaves, refCut);
+                AigCheckResult cutRes;
+                std::string cutErr;
+                if (AigCheckAigs(refCut, newCut, cutRes, cutErr) && cutRes.equivalent) {
+                    res.equivalent = true;
+                    checked_ = &g;
+                    return true;
+                }
+            }
+        }
+
+        // 3b. 邊界上的 don't care 讓上面無法證明：逐 output 檢查整個 cone
+        for (int j : changed) {
+            stats_.nFullCones++;
+            AigGraph refCone, newCone;
+            std::vector<int> support;
+            ExtractOutputCone(ref_, g, j, refCone, newCone, support);
+            AigCheckResult coneRes;
+            bool decided;
+            if ((int)support.size() <= AIG_CHECK_MAX_VARS) decided = AigCheckAigs(refCone, newCone, coneRes, err);
+            else if (fallback) decided = fallback(refCone, newCone, coneRes, err);
+            else {
+                err = "Error: cone of output " + std::to_string(j) + " has " + std::to_string(support.size()) +
+                      " inputs and no fallback checker";
+                decided = false;
+            }
+            if (!decided) return false;
+            if (!coneRes.equivalent) {
+                res.method = coneRes.method;
+                res.equivalent = false;
+                res.output = j;
+                res.minterm = 0;
+                for (size_t s = 0; s < support.size() && support[s] < 64; ++s)
+                    if ((coneRes.minterm >> s) & 1) res.minterm |= 1ULL << support[s];
+                res.reason = "output " + std::to_string(j) + " differs at minterm " + std::to_string(res.minterm);
+                return true;
+            }
+        }
+        res.equivalent = true;
+        checked_ = &g;
+        return true;
+    }
+
+    // 剛通過 Check 的 g 成為新的參考電路；對應到的節點直接沿用 signature
+    bool Commit(const AigGraph& g) {
+        if (checked_ != &g) return false;
+        const unsigned kNone = ~0u;
+        std::vector<uint64_t> sig((size_t)(g.MaxVar() + 1) * AIG_SIG_WORDS, 0);
+        for (unsigned v = 1; v <= (unsigned)g.nPis; ++v)
+            std::copy(&sig_[(size_t)v * AIG_SIG_WORDS], &sig_[(size_t)(v + 1) * AIG_SIG_WORDS], &sig[(size_t)v * AIG_SIG_WORDS]);
+        for (int k = 0; k < g.AndNum(); ++k) {
+            unsigned v = g.AndLit(k) >> 1;
+            uint64_t* o = &sig[(size_t)v * AIG_SIG_WORDS];
+            if (map_[v] != kNone) {
+                const uint64_t* r = &sig_[(size_t)(map_[v] >> 1) * AIG_SIG_WORDS];
+                std::copy(r, r + AIG_SIG_WORDS, o);
+            } else if (!newSig_.empty() && simulated_[v]) {
+                std::copy(&newSig_[(size_t)v * AIG_SIG_WORDS], &newSig_[(size_t)(v + 1) * AIG_SIG_WORDS], o);
+            } else {
+                SimAnd(o, sig, g.fanin0[k], g.fanin1[k]);
+            }
+        }
+        sig_.swap(sig);
+        ref_ = g;
+        BuildTable();
+        checked_ = nullptr;
+        return true;
+    }
+
+private:
+    uint64_t seed_;
+    bool valid_ = false;
+    AigGraph ref_;
+    std::vector<uint64_t> pi_;          // PI i 的 pattern：pi_[i * AIG_SIG_WORDS + w]
+    std::vector<uint64_t> sig_;         // 參考電路每個 var 的 signature
+    std::unordered_map<uint64_t, unsigned> table_;  // (fanin0, fanin1) -> 參考電路的 var
+    AigIncrementalStats stats_;
+
+    // 上一次 Check 的結果，Commit 時沿用
+    const AigGraph* checked_ = nullptr;
+    std::vector<unsigned> map_;         // 新 var -> 參考電路的 literal（~0u = 沒有對應）
+    std::vector<uint64_t> newSig_;
+    std::vector<char> simulated_;
+
+    static uint64_t Key(unsigned f0, unsigned f1) { return ((uint64_t)f0 << 32) | f1; }
+
+    unsigned MapLit(unsigned lit) const {
+        unsigned m = map_[lit >> 1];
+        return m == ~0u ? ~0u : m ^ (lit & 1u);
+    }
+
+    void BuildTable() {
+        table_.clear();
+        table_.reserve((size_t)ref_.AndNum() * 2);
+        for (int k = 0; k < ref_.AndNum(); ++k)
+            table_.emplace(Key(ref_.fanin0[k], ref_.fanin1[k]), ref_.AndLit(k) >> 1);
+    }
+
+    static void SimAnd(uint64_t* o, const std::vector<uint64_t>& sig, unsigned f0, unsigned f1) {
+        const uint64_t* a = &sig[(size_t)(f0 >> 1) * AIG_SIG_WORDS];
+        const uint64_t* b = &sig[(size_t)(f1 >> 1) * AIG_SIG_WORDS];
+        uint64_t ca = (f0 & 1) ? ~0ULL : 0, cb = (f1 & 1) ? ~0ULL : 0;
+        for (int w = 0; w < AIG_SIG_WORDS; ++w) o[w] = (a[w] ^ ca) & (b[w] ^ cb);
+    }
+
+    // 新電路中 var v 的 signature：對應到的節點用參考電路的（map_ 只記正相 literal），否則用剛算好的
+    const uint64_t* NewSig(unsigned v) const {
+        unsigned m = map_[v];
+        if (m != ~0u) return &sig_[(size_t)(m >> 1) * AIG_SIG_WORDS];
+        return &newSig_[(size_t)v * AIG_SIG_WORDS];
+    }
+
+    // roots 之下到 isLeaf 為止的 AND（拓撲順序），以及遇到的 leaf var（常數除外）
+    template <typename LeafFn>
+    static void CutCollect(const AigGraph& g, const std::vector<unsigned>& roots, LeafFn isLeaf,
+                           std::vector<unsigned>& leaves, std::vector<int>& ands) {
+        int base = 1 + g.nPis;
+        std::vector<char> mark(g.MaxVar() + 1, 0);
+        std::vector<unsigned> stack;
+        leaves.clear();
+        ands.clear();
+        auto leaf = [&](unsigned v) {
+            if (v == 0) return true;
+            if (!isLeaf(v) && (int)v >= base) return false;
+            if (!mark[v]) {
+                mark[v] = 2;
+                leaves.push_back(v);
+            }
+            return true;
+        };
+        for (unsigned root : roots) {
+            if (mark[root >> 1] || leaf(root >> 1)) continue;
+            stack.push_back(root >> 1);
+            while (!stack.empty()) {
+                unsigned v = stack.back();
+                if (mark[v] == 2) { stack.pop_back(); continue; }
+                mark[v] = 1;
+                int k = (int)v - base;
+                bool ready = true;
+                for (unsigned f : {g.fanin0[k], g.fanin1[k]}) {
+                    unsigned c = f >> 1;
+                    if (mark[c] || leaf(c)) continue;
+                    stack.push_back(c);
+                    ready = false;
+                }
+                if (!ready) continue;
+                mark[v] = 2;
+                ands.push_back(k);
+                stack.pop_back();
+            }
+        }
+    }
+
+    // CutCollect 的結果建成獨立的 AIG：leafLit(v) 是 leaf 在新 AIG 中的 PI literal
+    template <typename LeafLitFn>
+    static void CutBuild(const AigGraph& g, const std::vector<unsigned>& roots, const std::vector<int>& ands,
+                         LeafLitFn leafLit, int nLeaves, AigGraph& out) {
+        AigStrash strash(nLeaves);
+        std::vector<unsigned> lit(g.MaxVar() + 1, ~0u);
+        lit[0] = 0;
+        auto litOf = [&](unsigned l) {
+            unsigned v = l >> 1;
+            if (lit[v] == ~0u) lit[v] = leafLit(v);
+            return lit[v] ^ (l & 1u);
+        };
+        for (int k : ands) lit[g.AndLit(k) >> 1] = strash.And(litOf(g.fanin0[k]), litOf(g.fanin1[k]));
+        std::vector<unsigned> outputs;
+        for (unsigned root : roots) outputs.push_back(litOf(root));
+        strash.Finish(outputs, out);
+    }
+
+    // 第 j 個 output 的完整 cone，PI 壓縮成兩邊 support 的聯集（support[i] = 原本的 PI index）
+    static void ExtractOutputCone(const AigGraph& ref, const AigGraph& g, int j, AigGraph& refCone,
+                                  AigGraph& newCone, std::vector<int>& support) {
+        auto noLeaf = [](unsigned) { return false; };
+        std::vector<unsigned> refLeaves, newLeaves;
+        std::vector<int> refAnds, newAnds;
+        CutCollect(ref, {ref.outputs[j]}, noLeaf, refLeaves, refAnds);
+        CutCollect(g, {g.outputs[j]}, noLeaf, newLeaves, newAnds);
+        std::vector<int> pos(ref.nPis + 1, -1);
+        for (unsigned v : refLeaves) pos[v] = 0;
+        for (unsigned v : newLeaves) pos[v] = 0;
+        support.clear();
+        for (int v = 1; v <= ref.nPis; ++v)
+            if (pos[v] == 0) {
+                pos[v] = (int)support.size();
+                support.push_back(v - 1);
+            }
+        int n = (int)support.size();
+        auto leafLit = [&](unsigned v) { return 2u * (unsigned)(1 + pos[v]); };
+        CutBuild(ref, {ref.outputs[j]}, refAnds, leafLit, n, refCone);
+        CutBuild(g, {g.outputs[j]}, newAnds, leafLit, n, newCone);
+    }
+};
+
+#endif
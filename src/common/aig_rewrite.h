@@ -0,0 +1,249 @@
+#ifndef COMMON_AIG_REWRITE_H
+#define COMMON_AIG_REWRITE_H
+
+// =========================================================
+// Cut rewriting with the exact database (common/exact_db.h)
+//
+// Every AND gets up to AIG_REWRITE_CUTS cuts of at most 4 leaves, merged
+// from the cuts of its fanins, each with its 16-bit function.  Cuts whose
+// leaves are all PIs come first, so an output with at most 4 inputs in its
+// support is always tried as a whole; the rest are kept smallest first.
+//
+// A node is replaced by the database structure of its best cut when that
+// structure has fewer ANDs than the node's MFFC inside the cut (the ANDs
+// only the node uses, which go away with it).  Choices are made on the
+// input graph, and the result is rebuilt from the outputs through
+// AigStrash: the interior of a replaced node survives only if something
+// else still reads it, and new structures share existing nodes where they
+// can.  The gain estimate is only a guide; callers keep the result only
+// if it is actually smaller (AigExactRewrite returns false otherwise).
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "common/aig_window.h"
+#include "common/aiger.h"
+#include "common/exact_db.h"
+
+const int AIG_REWRITE_CUTS = 8;  // 每個節點保留的 cut 數（不含 trivial cut）
+
+struct AigCut {
+    int n = 0;
+    int leaf[4] = {0, 0, 0, 0};  // AIG var，遞增
+    uint16_t tt = 0;             // leaf p = x_p（ExactDbKey 的格式）
+    bool allPis = true;
+};
+
+struct AigRewriteStats {
+    int nCuts = 0;       // 所有節點的 cut 數
+    int nChosen = 0;     // 選擇替換的節點
+    int nBefore = 0;
+    int nAfter = 0;
+};
+
+// =========================================================
+// Cuts
+// =========================================================
+
+// sub 的函數展開到 super 的 leaf 上（sub 的 leaf 一定都在 super 中）
+inline uint16_t AigCutExpand(const AigCut& sub, const AigCut& super) {
+    int pos[4] = {0, 0, 0, 0};
+    for (int i = 0, q = 0; i < sub.n; ++i) {
+        while (super.leaf[q] != sub.leaf[i]) ++q;
+        pos[i] = q;
+    }
+    uint16_t t = 0;
+    for (int m = 0; m < 16; ++m) {
+        int s = 0;
+        for (int i = 0; i < sub.n; ++i) s |= ((m >> pos[i]) & 1) << i;
+        t |= (uint16_t)(((sub.tt >> s) & 1) << m);
+    }
+    return t;
+}
+
+inline bool AigCutMerge(const AigCut& a, const AigCut& b, AigCut& c) {
+    int i = 0, j = 0;
+    c.n = 0;
+    while (i < a.n || j < b.n) {
+        int x;
+        if (j >= b.n || (i < a.n && a.leaf[i] < b.leaf[j])) x = a.leaf[i++];
+        else if (i >= a.n || b.leaf[j] < a.leaf[i]) x = b.leaf[j++];
+        else x = a.leaf[i++], ++j;
+        if (c.n == 4) return false;
+        c.leaf[c.n++] = x;
+    }
+    c.allPis = a.allPis && b.allPis;
+    return true;
+}
+
+// cuts[var]：PI 只有 trivial cut，AND 的 trivial cut 放在最後（給 fanout 合併用）
+inline void AigEnumerateCuts(const AigGraph& g, std::vector<std::vector<AigCut>>& cuts) {
+    int base = 1 + g.nPis + g.nLatches;
+    cuts.assign(g.MaxVar() + 1, {});
+    AigCut c0;
+    c0.tt = 0;
+    cuts[0].push_back(c0);  // 常數：沒有 leaf
+    for (int v = 1; v < base; ++v) {
+        AigCut c;
+        c.n = 1;
+        c.leaf[0] = v;
+        c.tt = 0xAAAA;
+        c.allPis = v <= g.nPis;
+        cuts[v].push_back(c);
+    }
+    std::vector<AigCut> cand;
+    for (int k = 0; k < g.AndNum(); ++k) {
+        int v = base + k;
+        unsigned l0 = g.fanin0[k], l1 = g.fanin1[k];
+        cand.clear();
+        for (const AigCut& a : cuts[l0 >> 1])
+            for (const AigCut& b : cuts[l1 >> 1]) {
+                AigCut c;
+                if (!AigCutMerge(a, b, c)) continue;
+                bool dup = false;
+                for (const AigCut& d : cand)
+                    if (d.n == c.n && std::equal(d.leaf, d.leaf + d.n, c.leaf)) { dup = true; break; }
+                if (dup) continue;
+                uint16_t t0 = AigCutExpand(a, c) ^ ((l0 & 1u) ? 0xFFFF : 0);
+                uint16_t t1 = AigCutExpand(b, c) ^ ((l1 & 1u) ? 0xFFFF : 0);
+                c.tt = t0 & t1;
+                cand.push_back(c);
+            }
+        std::stable_sort(cand.begin(), cand.end(), [](const AigCut& a, const AigCut& b) {
+            if (a.allPis != b.allPis) return a.allPis;
+            return a.n < b.n;
+        });
+        if ((int)cand.size() > AIG_REWRITE_CUTS) cand.resize(AIG_REWRITE_CUTS);
+        AigCut self;
+        self.n = 1;
+        self.leaf[0] = v;
+        self.tt = 0xAAAA;
+        self.allPis = false;
+        cand.push_back(self);
+        cuts[v] = cand;
+    }
+}
+
+// =========================================================
+// MFFC
+// =========================================================
+
+class AigMffc {
+public:
+    explicit AigMffc(const AigGraph& g) : g_(g), base_(1 + g.nPis + g.nLatches), refs_(g.MaxVar() + 1, 0) {
+        for (int k = 0; k < g.AndNum(); ++k) {
+            ++refs_[g.fanin0[k] >> 1];
+            ++refs_[g.fanin1[k] >> 1];
+        }
+        for (unsigned l : g.outputs) ++refs_[l >> 1];
+    }
+
+    // v 在 cut 內、只被 v 使用的 AND 數（包含 v）
+    int Size(int v, const AigCut& cut) {
+        cut_ = &cut;
+        int n = Deref(v);
+        Ref(v);
+        return n;
+    }
+
+private:
+    bool Stop(int u) const {
+        if (u < base_) return true;
+        for (int i = 0; i < cut_->n; ++i)
+            if (cut_->leaf[i] == u) return true;
+        return false;
+    }
+
+    int Deref(int v) {
+        int n = 1, k = v - base_;
+        for (unsigned l : {g_.fanin0[k], g_.fanin1[k]}) {
+            int u = (int)(l >> 1);
+            if (!Stop(u) && --refs_[u] == 0) n += Deref(u);
+        }
+        return n;
+    }
+
+    void Ref(int v) {
+        int k = v - base_;
+        for (unsigned l : {g_.fanin0[k], g_.fanin1[k]}) {
+            int u = (int)(l >> 1);
+            if (!Stop(u) && refs_[u]++ == 0) Ref(u);
+        }
+    }
+
+    const AigGraph& g_;
+    int base_;
+    std::vector<int> refs_;
+    const AigCut* cut_ = nullptr;
+};
+
+// =========================================================
+// Rewrite
+// =========================================================
+
+// 回傳 true = out 比 g 小；只處理組合電路
+inline bool AigExactRewrite(const AigGraph& g, const ExactDb& db, AigGraph& out, AigRewriteStats* pStats = nullptr) {
+    AigRewriteStats stats;
+    stats.nBefore = stats.nAfter = g.AndNum();
+    if (pStats) *pStats = stats;
+    if (g.nLatches > 0) return false;
+    int base = 1 + g.nPis;
+    std::vector<std::vector<AigCut>> cuts;
+    AigEnumerateCuts(g, cuts);
+
+    // ------- 每個 AND 選最好的 cut -------
+    AigMffc mffc(g);
+    std::vector<int> choice(g.MaxVar() + 1, -1);
+    for (int k = 0; k < g.AndNum(); ++k) {
+        int v = base + k;
+        int bestGain = 0;
+        for (int c = 0; c + 1 < (int)cuts[v].size(); ++c) {
+            ++stats.nCuts;
+            int gain = mffc.Size(v, cuts[v][c]) - db.Cost(cuts[v][c].tt);
+            if (gain > bestGain) {
+                bestGain = gain;
+                choice[v] = c;
+            }
+        }
+        if (choice[v] >= 0) ++stats.nChosen;
+    }
+
+    // ------- 從 output 往回標出要建的節點，再依拓撲順序重建 -------
+    std::vector<char> needed(g.MaxVar() + 1, 0);
+    for (unsigned l : g.outputs) needed[l >> 1] = 1;
+    for (int v = g.MaxVar(); v >= base; --v) {
+        if (!needed[v]) continue;
+        if (choice[v] >= 0) {
+            const AigCut& c = cuts[v][choice[v]];
+            for (int i = 0; i < c.n; ++i) needed[c.leaf[i]] = 1;
+        } else {
+            needed[g.fanin0[v - base] >> 1] = 1;
+            needed[g.fanin1[v - base] >> 1] = 1;
+        }
+    }
+    AigStrash strash(g.nPis);
+    std::vector<unsigned> lit(g.MaxVar() + 1, 0);
+    for (int v = 1; v < base; ++v) lit[v] = strash.PiLit(v - 1);
+    auto map = [&](unsigned l) { return lit[l >> 1] ^ (l & 1u); };
+    for (int v = base; v <= g.MaxVar(); ++v) {
+        if (!needed[v]) continue;
+        if (choice[v] >= 0) {
+            const AigCut& c = cuts[v][choice[v]];
+            unsigned leaves[4] = {0, 0, 0, 0};
+            for (int i = 0; i < c.n; ++i) leaves[i] = lit[c.leaf[i]];
+            lit[v] = db.Build(c.tt, leaves, strash);
+        } else {
+            lit[v] = strash.And(map(g.fanin0[v - base]), map(g.fanin1[v - base]));
+        }
+    }
+    std::vector<unsigned> outputs;
+    for (unsigned l : g.outputs) outputs.push_back(map(l));
+    strash.Finish(outputs, out);
+    stats.nAfter = out.AndNum();
+    if (pStats) *pStats = stats;
+    return out.AndNum() < g.AndNum();
+}
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef COMMON_AIG_WINDOW_H
+#define COMMON_AIG_WINDOW_H
+
+// =========================================================
+// AIG windowing: partition / stitch / strash
+//
+// AigPartition cuts the AND nodes of a combinational AigGraph into disjoint
+// windows.  The nodes are first put in DFS post-order from the outputs, so
+// the cone of each output stays together, and the order is then cut into
+// contiguous ranges.  A window only reads signals of earlier windows (or
+// PIs), and every window becomes a standalone AIG:
+//   inputs  = signals from outside the window
+//   outputs = window nodes used by a later window or by a PO
+// Each window can be optimized on its own (as long as its outputs keep
+// their functions of its inputs), and AigStitch puts the windows back in
+// order through AigStrash, which hashes, folds constants and drops
+// dangling nodes.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/aiger.h"
+
+// =========================================================
+// Structural hashing
+// =========================================================
+
+class AigStrash {
+public:
+    explicit AigStrash(int nPis) : nPis_(nPis) {}
+
+    unsigned PiLit(int i) const { return 2u * (unsigned)(1 + i); }
+
+    unsigned And(unsigned a, unsigned b) {
+        if (a < b) std::swap(a, b);
+        // 常數與重複 fanin
+        if (b == 0 || a == (b ^ 1u)) return 0;
+        if (b == 1 || a == b) return a;
+        uint64_t key = ((uint64_t)a << 32) | b;
+        auto it = table_.find(key);
+        if (it != table_.end()) return it->second;
+        unsigned lit = 2u * (unsigned)(1 + nPis_ + (int)fanin0_.size());
+        fanin0_.push_back(a);
+        fanin1_.push_back(b);
+        table_.emplace(key, lit);
+        return lit;
+    }
+
+    // 只保留 outputs 用得到的 AND，重新編號（原本就是拓撲順序）
+    void Finish(const std::vector<unsigned>& outputs, AigGraph& g) const {
+        int nAnds = (int)fanin0_.size();
+        int base = 1 + nPis_;
+        std::vector<char> used(nAnds, 0);
+        for (unsigned lit : outputs)
+            if ((int)(lit >> 1) >= base) used[(lit >> 1) - base] = 1;
+        for (int k = nAnds - 1; k >= 0; --k) {
+            if (!used[k]) continue;
+            for (unsigned f : {fanin0_[k], fanin1_[k]})
+                if ((int)(f >> 1) >= base) used[(f >> 1) - base] = 1;
+        }
+        std::vector<unsigned> newVar(nAnds, 0);
+        g = AigGraph();
+        g.nPis = nPis_;
+        auto remap = [&](unsigned lit) {
+            unsigned v = lit >> 1;
+            return (int)v < base ? lit : 2u * newVar[v - base] + (lit & 1u);
+        };
+        for (int k = 0; k < nAnds; ++k) {
+            if (!used[k]) continue;
+            newVar[k] = (unsigned)(base + g.AndNum());
+            unsigned f0 = remap(fanin0_[k]), f1 = remap(fanin1_[k]);
+            g.fanin0.push_back(std::max(f0, f1));
+            g.fanin1.push_back(std::min(f0, f1));
+        }
+        for (unsigned lit : outputs) g.outputs.push_back(remap(lit));
+    }
+
+private:
+    int nPis_;
+    std::vector<unsigned> fanin0_, fanin1_;
+    std::unordered_map<uint64_t, unsigned> table_;
+};
+
+// =========================================================
+// Partition
+// =========================================================
+
+struct AigWindow {
+    std::vector<unsigned> inputs;   // 外部訊號（parent 的正相 literal），依序對應 graph 的 PI
+    std::vector<unsigned> outputs;  // 被外部使用的 window 節點（parent 的正相 literal）
+    std::vector<int> nodes;         // parent 的 AND index，拓撲順序
+    AigGraph graph;                 // 獨立的組合電路
+};
+
+// 從 PO 出發的 DFS post-order（AND index）；用不到的 AND 不會出現
+inline std::vector<int> AigDfsOrder(const AigGraph& g) {
+    int base = 1 + g.nPis + g.nLatches;
+    std::vector<char> mark(g.AndNum(), 0);
+    std::vector<int> order, stack;
+    order.reserve(g.AndNum());
+    std::vector<unsigned> roots = g.outputs;
+    roots.insert(roots.end(), g.latchNext.begin(), g.latchNext.end());
+    for (unsigned root : roots) {
+        int r = (int)(root >> 1) - base;
+        if (r < 0 || mark[r]) continue;
+        stack.push_back(r);
+        while (!stack.empty()) {
+            int k = stack.back();
+            if (mark[k] == 2) { stack.pop_back(); continue; }
+            mark[k] = 1;
+            bool ready = true;
+            for (unsigned f : {g.fanin0[k], g.fanin1[k]}) {
+                int c = (int)(f >> 1) - base;
+                if (c >= 0 && !mark[c]) {
+                    stack.push_back(c);
+                    ready = false;
+                }
+            }
+            if (!ready) continue;
+            mark[k] = 2;
+            order.push_back(k);
+            stack.pop_back();
+        }
+    }
+    return order;
+}
+
+// nWindows 個大小接近的 window；shift 把切點往前移（每輪換一組邊界用）
+inline bool AigPartition(const AigGraph& g, int nWindows, int shift, std::vector<AigWindow>& windows,
+                         std::string& err) {
+    if (g.nLatches > 0) {
+        err = "Error: windowing supports combinational AIGs only";
+        return false;
+    }
+    std::vector<int> order = AigDfsOrder(g);
+    int n = (int)order.size();
+    nWindows = std::max(1, std::min(nWindows, n));
+    windows.assign(nWindows, AigWindow());
+    if (n == 0) return true;
+
+    int base = 1 + g.nPis;
+    std::vector<int> winOf(g.AndNum(), -1);
+    for (int w = 0, pos = 0; w < nWindows; ++w) {
+        int end = (w == nWindows - 1) ? n : std::max(pos + 1, (int)((int64_t)n * (w + 1) / nWindows) - shift);
+        end = std::min(end, n - (nWindows - 1 - w));
+        for (; pos < end; ++pos) {
+            winOf[order[pos]] = w;
+            windows[w].nodes.push_back(order[pos]);
+        }
+    }
+
+    // 被其他 window 或 PO 使用的節點就是 window output
+    std::vector<char> usedOutside(g.AndNum(), 0);
+    for (int k : order)
+        for (unsigned f : {g.fanin0[k], g.fanin1[k]}) {
+            int c = (int)(f >> 1) - base;
+            if (c >= 0 && winOf[c] != winOf[k]) usedOutside[c] = 1;
+        }
+    for (unsigned lit : g.outputs)
+        if ((int)(lit >> 1) >= base) usedOutside[(lit >> 1) - base] = 1;
+
+    std::vector<unsigned> local(g.MaxVar() + 1, 0);  // parent var -> window 內的 var（每個 window 重設用到的部分）
+    for (int w = 0; w < nWindows; ++w) {
+        AigWindow& win = windows[w];
+        // 先收集 input，才知道 AND 的編號從哪裡開始
+        for (int k : win.nodes)
+            for (unsigned f : {g.fanin0[k], g.fanin1[k]}) {
+                unsigned v = f >> 1;
+                if (v == 0 || local[v] != 0) continue;
+                int c = (int)v - base;
+                if (c >= 0 && winOf[c] == w) continue;
+                win.inputs.push_back(2u * v);
+                local[v] = (unsigned)win.inputs.size();
+            }
+        AigGraph& wg = win.graph;
+        wg.nPis = (int)win.inputs.size();
+        for (int j = 0; j < (int)win.nodes.size(); ++j) local[base + win.nodes[j]] = (unsigned)(1 + wg.nPis + j);
+        wg.fanin0.assign(win.nodes.size(), 0);
+        wg.fanin1.assign(win.nodes.size(), 0);
+        for (int j = 0; j < (int)win.nodes.size(); ++j) {
+            int k = win.nodes[j];
+            unsigned f0 = 2u * local[g.fanin0[k] >> 1] + (g.fanin0[k] & 1u);
+            unsigned f1 = 2u * local[g.fanin1[k] >> 1] + (g.fanin1[k] & 1u);
+            wg.fanin0[j] = std::max(f0, f1);
+            wg.fanin1[j] = std::min(f0, f1);
+        }
+        for (int k : win.nodes)
+            if (usedOutside[k]) {
+                win.outputs.push_back(2u * (unsigned)(base + k));
+                wg.outputs.push_back(2u * local[base + k]);
+            }
+        // 清掉這個 window 的編號，下一個 window 重新開始
+        for (unsigned lit : win.inputs) local[lit >> 1] = 0;
+        for (int k : win.nodes) local[base + k] = 0;
+    }
+    return true;
+}
+
+// =========================================================
+// Stitch
+// =========================================================
+
+// replacement[w] 為 nullptr 時用原本的 window；替換的 window 必須有相同的 I/O 數
+inline bool AigStitch(const AigGraph& g, const std::vector<AigWindow>& windows,
+                      const std::vector<const AigGraph*>& replacement, AigGraph& out, std::string& err) {
+    AigStrash strash(g.nPis);
+    std::vector<unsigned> map(g.MaxVar() + 1, 0);
+    for (int i = 0; i < g.nPis; ++i) map[1 + i] = strash.PiLit(i);
+    auto mapLit = [&](unsigned lit) { return map[lit >> 1] ^ (lit & 1u); };
+
+    std::vector<unsigned> local;
+    for (size_t w = 0; w < windows.size(); ++w) {
+        const AigWindow& win = windows[w];
+        const AigGraph& wg = replacement[w] ? *replacement[w] : win.graph;
+        if (wg.nPis != (int)win.inputs.size() || wg.outputs.size() != win.outputs.size() || wg.nLatches) {
+            err = "Error: window " + std::to_string(w) + " interface mismatch";
+            return false;
+        }
+        local.assign(wg.MaxVar() + 1, 0);
+        for (int i = 0; i < wg.nPis; ++i) local[1 + i] = mapLit(win.inputs[i]);
+        auto localLit = [&](unsigned lit) { return local[lit >> 1] ^ (lit & 1u); };
+        for (int k = 0; k < wg.AndNum(); ++k)
+            local[wg.AndLit(k) >> 1] = strash.And(localLit(wg.fanin0[k]), localLit(wg.fanin1[k]));
+        for (size_t o = 0; o < win.outputs.size(); ++o) map[win.outputs[o] >> 1] = localLit(wg.outputs[o]);
+    }
+
+    std::vector<unsigned> outputs;
+    outputs.reserve(g.outputs.size());
+    for (unsigned lit : g.outputs) outputs.push_back(mapLit(lit));
+    strash.Finish(outputs, out);
+    return true;
+}
+
+#endif
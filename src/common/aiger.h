@@ -0,0 +1,390 @@
+#ifndef COMMON_AIGER_H
+#define COMMON_AIGER_H
+
+// =========================================================
+// AIGER reader / writer
+//
+// Reads binary ("aig") and ASCII ("aag") AIGER from a memory-mapped file
+// into flat fanin arrays, and writes binary AIGER or BENCH back out.
+//
+// Layout after reading (both formats): variable 0 is constant 0, inputs
+// are variables 1..I, latches I+1..I+L, and AND k is variable I+L+1+k with
+// fanin0 >= fanin1 (AIGER literals, bit 0 = complement).  ASCII files are
+// renumbered into this order, ANDs topologically sorted.  Symbol tables
+// and comments are skipped.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/mapped_file.h"
+
+struct AigerHeader {
+    bool binary = true;
+    unsigned M = 0, I = 0, L = 0, O = 0, A = 0;
+    unsigned B = 0, C = 0;  // AIGER 1.9 bad / constraint 數（讀取時略過）
+};
+
+struct AigGraph {
+    int nPis = 0;
+    int nLatches = 0;
+    std::vector<unsigned> latchNext;  // next-state literal per latch
+    std::vector<unsigned> outputs;    // PO literals
+    std::vector<unsigned> fanin0;     // per AND, fanin0[k] >= fanin1[k]
+    std::vector<unsigned> fanin1;
+
+    int AndNum() const { return (int)fanin0.size(); }
+    int MaxVar() const { return nPis + nLatches + AndNum(); }
+    unsigned AndLit(int k) const { return 2u * (unsigned)(1 + nPis + nLatches + k); }
+};
+
+// =========================================================
+// Parsing helpers
+// =========================================================
+
+struct AigerCursor {
+    const char* p;
+    const char* end;
+
+    bool AtEnd() const { return p >= end; }
+    void SkipBlanks() { while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p; }
+    void SkipLine() {
+        while (p < end && *p != '\n') ++p;
+        if (p < end) ++p;
+    }
+    bool ReadUInt(unsigned& x) {
+        SkipBlanks();
+        if (p >= end || *p < '0' || *p > '9') return false;
+        uint64_t v = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            v = v * 10 + (unsigned)(*p++ - '0');
+            if (v > 0xFFFFFFFFu) return false;
+        }
+        x = (unsigned)v;
+        return true;
+    }
+    bool AtEol() {
+        SkipBlanks();
+        return p >= end || *p == '\n';
+    }
+    // binary AIGER 的 7-bit varint
+    bool ReadDelta(unsigned& x) {
+        x = 0;
+        for (int shift = 0; p < end && shift < 35; shift += 7) {
+            unsigned char b = (unsigned char)*p++;
+            x |= (unsigned)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+};
+
+inline bool AigerParseHeader(AigerCursor& c, AigerHeader& hdr, std::string& err) {
+    c.SkipBlanks();
+    if (c.end - c.p >= 4 && std::string(c.p, 4) == "aig ") hdr.binary = true;
+    else if (c.end - c.p >= 4 && std::string(c.p, 4) == "aag ") hdr.binary = false;
+    else { err = "Error: Expected 'aig' or 'aag' header"; return false; }
+    c.p += 3;
+    if (!c.ReadUInt(hdr.M) || !c.ReadUInt(hdr.I) || !c.ReadUInt(hdr.L) || !c.ReadUInt(hdr.O) || !c.ReadUInt(hdr.A)) {
+        err = "Error: Malformed AIGER header";
+        return false;
+    }
+    // AIGER 1.9：B C J F，只接受 bad / constraint
+    unsigned extra[4] = {0, 0, 0, 0};
+    for (int k = 0; k < 4 && !c.AtEol(); ++k) {
+        if (!c.ReadUInt(extra[k])) { err = "Error: Malformed AIGER header"; return false; }
+    }
+    if (extra[2] || extra[3]) {
+        err = "Error: AIGER justice / fairness properties are not supported";
+        return false;
+    }
+    hdr.B = extra[0];
+    hdr.C = extra[1];
+    c.SkipLine();
+    return true;
+}
+
+// 只讀 header（例如只要 AND 數）
+inline bool AigerReadHeader(const std::string& filename, AigerHeader& hdr, std::string& err) {
+    MappedFile file;
+    if (!file.Open(filename)) {
+        err = "Error: Cannot open AIG file: " + filename;
+        return false;
+    }
+    AigerCursor c = {file.Data(), file.Data() + file.Size()};
+    return AigerParseHeader(c, hdr, err);
+}
+
+// =========================================================
+// Reader
+// =========================================================
+
+inline bool AigerReadBinary(AigerCursor& c, const AigerHeader& hdr, AigGraph& g, std::string& err) {
+    if (hdr.M != hdr.I + hdr.L + hdr.A) {
+        err = "Error: Binary AIGER requires M = I + L + A";
+        return false;
+    }
+    for (unsigned i = 0; i < hdr.L; ++i) {
+        if (!c.ReadUInt(g.latchNext[i])) { err = "Error: Malformed latch line"; return false; }
+        c.SkipLine();
+    }
+    for (unsigned i = 0; i < hdr.O; ++i) {
+        if (!c.ReadUInt(g.outputs[i])) { err = "Error: Malformed output line"; return false; }
+        c.SkipLine();
+    }
+    for (unsigned i = 0; i < hdr.B + hdr.C; ++i) c.SkipLine();
+    for (unsigned k = 0; k < hdr.A; ++k) {
+        unsigned lhs = 2u * (hdr.I + hdr.L + 1 + k);
+        unsigned d0, d1;
+        if (!c.ReadDelta(d0) || !c.ReadDelta(d1) || d0 == 0 || d0 > lhs || d1 > lhs - d0) {
+            err = "Error: Malformed AND delta encoding";
+            return false;
+        }
+        g.fanin0[k] = lhs - d0;
+        g.fanin1[k] = lhs - d0 - d1;
+    }
+    return true;
+}
+
+inline bool AigerReadAscii(AigerCursor& c, const AigerHeader& hdr, AigGraph& g, std::string& err) {
+    const unsigned kNone = ~0u;
+    // 檔案中的 var → 新編號後的 literal
+    std::vector<unsigned> map(hdr.M + 1, kNone);
+    std::vector<unsigned> andLhs(hdr.A), andR0(hdr.A), andR1(hdr.A);
+    std::vector<unsigned> andOfVar(hdr.M + 1, kNone);
+    map[0] = 0;
+
+    auto badLit = [&](unsigned lit) { return (lit >> 1) > hdr.M; };
+    for (unsigned i = 0; i < hdr.I; ++i) {
+        unsigned lit;
+        if (!c.ReadUInt(lit) || (lit & 1) || lit == 0 || badLit(lit)) { err = "Error: Malformed input line"; return false; }
+        map[lit >> 1] = 2u * (1 + i);
+        c.SkipLine();
+    }
+    std::vector<unsigned> latchNextRaw(hdr.L);
+    for (unsigned i = 0; i < hdr.L; ++i) {
+        unsigned lit;
+        if (!c.ReadUInt(lit) || !c.ReadUInt(latchNextRaw[i]) || (lit & 1) || badLit(lit) || badLit(latchNextRaw[i])) {
+            err = "Error: Malformed latch line";
+            return false;
+        }
+        map[lit >> 1] = 2u * (1 + hdr.I + i);
+        c.SkipLine();
+    }
+    std::vector<unsigned> outputsRaw(hdr.O);
+    for (unsigned i = 0; i < hdr.O; ++i) {
+        if (!c.ReadUInt(outputsRaw[i]) || badLit(outputsRaw[i])) { err = "Error: Malformed output line"; return false; }
+        c.SkipLine();
+    }
+    for (unsigned i = 0; i < hdr.B + hdr.C; ++i) c.SkipLine();
+    for (unsigned k = 0; k < hdr.A; ++k) {
+        if (!c.ReadUInt(andLhs[k]) || !c.ReadUInt(andR0[k]) || !c.ReadUInt(andR1[k]) ||
+            (andLhs[k] & 1) || badLit(andLhs[k]) || badLit(andR0[k]) || badLit(andR1[k]) ||
+            andOfVar[andLhs[k] >> 1] != kNone) {
+            err = "Error: Malformed AND line";
+            return false;
+        }
+        andOfVar[andLhs[k] >> 1] = k;
+        c.SkipLine();
+    }
+
+    // AND 依拓撲順序重新編號（iterative DFS，檔案順序當根）
+    std::vector<char> state(hdr.A, 0);  // 0 = 未訪問, 1 = 在堆疊中, 2 = 完成
+    std::vector<unsigned> stack;
+    unsigned next = 0;
+    for (unsigned root = 0; root < hdr.A; ++root) {
+        if (state[root]) continue;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            unsigned k = stack.back();
+            if (state[k] == 2) { stack.pop_back(); continue; }
+            state[k] = 1;
+            bool ready = true;
+            for (unsigned lit : {andR0[k], andR1[k]}) {
+                unsigned f = andOfVar[lit >> 1];
+                if (f == kNone) {
+                    if (map[lit >> 1] == kNone) { err = "Error: AND fanin is undefined"; return false; }
+                    continue;
+                }
+                if (state[f] == 1) { err = "Error: Combinational cycle in AIGER file"; return false; }
+                if (state[f] == 0) { stack.push_back(f); ready = false; }
+            }
+            if (!ready) continue;
+            stack.pop_back();
+            state[k] = 2;
+            unsigned r0 = map[andR0[k] >> 1] ^ (andR0[k] & 1);
+            unsigned r1 = map[andR1[k] >> 1] ^ (andR1[k] & 1);
+            if (r0 < r1) std::swap(r0, r1);
+            g.fanin0[next] = r0;
+            g.fanin1[next] = r1;
+            map[andLhs[k] >> 1] = g.AndLit((int)next);
+            ++next;
+        }
+    }
+
+    auto remap = [&](unsigned lit, unsigned& out) {
+        if (map[lit >> 1] == kNone) return false;
+        out = map[lit >> 1] ^ (lit & 1);
+        return true;
+    };
+    for (unsigned i = 0; i < hdr.L; ++i)
+        if (!remap(latchNextRaw[i], g.latchNext[i])) { err = "Error: Latch input is undefined"; return false; }
+    for (unsigned i = 0; i < hdr.O; ++i)
+        if (!remap(outputsRaw[i], g.outputs[i])) { err = "Error: Output is undefined"; return false; }
+    return true;
+}
+
+inline bool AigerRead(const std::string& filename, AigGraph& g, std::string& err) {
+    MappedFile file;
+    if (!file.Open(filename)) {
+        err = "Error: Cannot open AIG file: " + filename;
+        return false;
+    }
+    AigerCursor c = {file.Data(), file.Data() + file.Size()};
+    AigerHeader hdr;
+    if (!AigerParseHeader(c, hdr, err)) return false;
+
+    g = AigGraph();
+    g.nPis = (int)hdr.I;
+    g.nLatches = (int)hdr.L;
+    g.latchNext.assign(hdr.L, 0);
+    g.outputs.assign(hdr.O, 0);
+    g.fanin0.assign(hdr.A, 0);
+    g.fanin1.assign(hdr.A, 0);
+
+    if (hdr.binary) return AigerReadBinary(c, hdr, g, err);
+    return AigerReadAscii(c, hdr, g, err);
+}
+
+// AND 的最大層數（PI / 常數為第 0 層）；AND 依拓撲順序所以一次掃過即可
+inline int AigLevelNum(const AigGraph& g) {
+    std::vector<int> level(g.MaxVar() + 1, 0);
+    int maxLevel = 0;
+    for (int k = 0; k < g.AndNum(); ++k) {
+        int l = 1 + std::max(level[g.fanin0[k] >> 1], level[g.fanin1[k] >> 1]);
+        level[g.AndLit(k) >> 1] = l;
+    }
+    for (unsigned lit : g.outputs) maxLevel = std::max(maxLevel, level[lit >> 1]);
+    return maxLevel;
+}
+
+// =========================================================
+// Writers
+// =========================================================
+
+inline bool AigerWriteBuffer(const std::string& filename, const std::string& buf, std::string& err) {
+    FILE* f = std::fopen(filename.c_str(), "wb");
+    if (!f) {
+        err = "Error: Cannot open output file: " + filename;
+        return false;
+    }
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) err = "Error: Failed to write " + filename;
+    return ok;
+}
+
+inline void AigerAppendDelta(std::string& buf, unsigned x) {
+    while (x & ~0x7fu) {
+        buf.push_back((char)((x & 0x7f) | 0x80));
+        x >>= 7;
+    }
+    buf.push_back((char)x);
+}
+
+// binary AIGER 寫進 buf；AND 必須已是拓撲順序（AigerRead 的結果一定是）
+inline bool AigerToBuffer(const AigGraph& g, std::string& buf, std::string& err) {
+    buf.clear();
+    buf.reserve(64 + 12 * (g.outputs.size() + g.latchNext.size()) + 4 * g.fanin0.size());
+    buf += "aig " + std::to_string(g.MaxVar()) + " " + std::to_string(g.nPis) + " " +
+           std::to_string(g.nLatches) + " " + std::to_string(g.outputs.size()) + " " +
+           std::to_string(g.AndNum()) + "\n";
+    for (unsigned lit : g.latchNext) buf += std::to_string(lit) + "\n";
+    for (unsigned lit : g.outputs) buf += std::to_string(lit) + "\n";
+    for (int k = 0; k < g.AndNum(); ++k) {
+        unsigned lhs = g.AndLit(k);
+        unsigned r0 = std::max(g.fanin0[k], g.fanin1[k]);
+        unsigned r1 = std::min(g.fanin0[k], g.fanin1[k]);
+        if (r0 >= lhs) {
+            err = "Error: AND gates are not in topological order";
+            return false;
+        }
+        AigerAppendDelta(buf, lhs - r0);
+        AigerAppendDelta(buf, r0 - r1);
+    }
+    return true;
+}
+
+inline bool AigerWrite(const std::string& filename, const AigGraph& g, std::string& err) {
+    std::string buf;
+    return AigerToBuffer(g, buf, err) && AigerWriteBuffer(filename, buf, err);
+}
+
+// 精簡的 BENCH（組合電路）：
+// - 節點名稱 n<var>，反相 literal 共用一個 inv_n<var> = NOT(n<var>)，第一次用到時才產生
+// - output 直接用驅動它的訊號名稱；只有 PI、常數、或與前面 output 重複時才多加一個 NOT
+//   （NOT 接在反相的訊號上，所以 inverter 仍是共用的）
+// - 常數用 n1 AND NOT(n1) 表示，沒有 input 時才退回 INPUT(GND) / INPUT(VCC)
+inline bool AigWriteBench(const std::string& filename, const AigGraph& g, std::string& err) {
+    if (g.nLatches > 0) {
+        err = "Error: BENCH writer supports combinational AIGs only";
+        return false;
+    }
+    std::string buf;
+    buf.reserve(64 + 40 * (g.fanin0.size() + g.outputs.size() + g.nPis));
+    std::vector<char> invDone(g.MaxVar() + 1, 0);
+    bool constDone = false;
+
+    buf += "# Converted from AIGER\n";
+    for (int i = 0; i < g.nPis; ++i) buf += "INPUT(n" + std::to_string(i + 1) + ")\n";
+
+    auto name = [&](unsigned lit) -> std::string {
+        unsigned v = lit >> 1;
+        if (v == 0) {
+            if (!constDone) {
+                constDone = true;
+                if (g.nPis > 0) {
+                    if (!invDone[1]) { buf += "inv_n1 = NOT(n1)\n"; invDone[1] = 1; }
+                    buf += "GND = AND(n1, inv_n1)\nVCC = NOT(GND)\n";
+                } else {
+                    buf += "INPUT(GND)\nINPUT(VCC)\n";
+                }
+            }
+            return (lit & 1) ? "VCC" : "GND";
+        }
+        std::string base = "n" + std::to_string(v);
+        if (!(lit & 1)) return base;
+        if (!invDone[v]) {
+            buf += "inv_" + base + " = NOT(" + base + ")\n";
+            invDone[v] = 1;
+        }
+        return "inv_" + base;
+    };
+
+    for (int k = 0; k < g.AndNum(); ++k) {
+        std::string a = name(g.fanin0[k]);
+        std::string b = name(g.fanin1[k]);
+        buf += "n" + std::to_string(g.AndLit(k) >> 1) + " = AND(" + a + ", " + b + ")\n";
+    }
+
+    std::vector<char> outUsed(2 * (g.MaxVar() + 1), 0);
+    for (size_t i = 0; i < g.outputs.size(); ++i) {
+        unsigned lit = g.outputs[i];
+        unsigned v = lit >> 1;
+        bool isPi = v >= 1 && v <= (unsigned)g.nPis && !(lit & 1);
+        if (!isPi && v != 0 && !outUsed[lit]) {
+            buf += "OUTPUT(" + name(lit) + ")\n";
+            outUsed[lit] = 1;
+            continue;
+        }
+        std::string po = "po" + std::to_string(i);
+        std::string src = name(lit ^ 1);
+        buf += "OUTPUT(" + po + ")\n" + po + " = NOT(" + src + ")\n";
+    }
+    return AigerWriteBuffer(filename, buf, err);
+}
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef COMMON_EXACT_DB_H
+#define COMMON_EXACT_DB_H
+
+// =========================================================
+// Exact-synthesis database: one small AIG per NPN class of 4-input
+// functions (222 classes), memory-mapped read-only.
+//
+// A 4-input function is a 16-bit truth table (truth_table.h bit order);
+// functions of fewer inputs are stretched, so the unused inputs are
+// don't-cares.  For every one of the 2^16 functions the file stores its
+// class and an NPN transform to the class root, so a lookup is one array
+// access:
+//   f(x) = root(z) ^ out,  z_p = x_{var[p]} ^ neg[p]
+// and the class AIG (built over z) is instantiated by feeding its input p
+// with leaf var[p] complemented by neg[p].
+//
+// The file is generated offline by bin/exactdb/main.  Classes whose
+// structure was found by exhaustive enumeration are marked exact
+// (minimum AND count); the others hold the best structure the builder
+// found.
+//
+// File layout (native byte order, every section 4-byte aligned):
+//   ExactDbHeader
+//   uint32_t func[65536]            class | transform (ExactDbPack)
+//   ExactDbClass cls[nClasses]
+//   uint16_t fanins[2 * nAnds]      AIGER literals of every class AIG
+// Class AIGs use var 0 = constant, 1..4 = inputs, 5.. = ANDs in order.
+// =========================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "common/aig_window.h"
+#include "common/mapped_file.h"
+#include "common/truth_npn.h"
+
+const uint32_t EXACT_DB_VERSION = 1;
+const int EXACT_DB_VARS = 4;
+const int EXACT_DB_FUNCS = 1 << (1 << EXACT_DB_VARS);
+const int EXACT_DB_MAX_ANDS = 32;  // 每個 class AIG 的上限
+const char EXACT_DB_MAGIC[8] = {'A', 'I', 'G', 'M', 'X', 'D', 'B', '\0'};
+
+struct ExactDbHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nVars;
+    uint32_t nClasses;
+    uint32_t nAnds;       // 所有 class AIG 的 AND 總數
+    uint32_t maxExact;    // 窮舉到的 AND 數：不超過這個數的 class 一定是最佳解
+    uint32_t reserved;
+    uint64_t checksum;    // header 之後所有內容的 FNV-1a
+};
+
+struct ExactDbClass {
+    uint32_t firstAnd;    // fanins 中的起點（以 AND 計）
+    uint16_t nAnds;
+    uint16_t outLit;      // class AIG 的 output literal
+    uint16_t root;        // class AIG 算的函數
+    uint16_t flags;       // EXACT_DB_FLAG_*
+};
+
+const uint16_t EXACT_DB_FLAG_EXACT = 1;
+
+// =========================================================
+// Transform packing
+// =========================================================
+
+// bits 0-11 class, 12 out, 13-16 neg[p], 17-24 var[p]（每個 2 bits）, 31 valid
+inline uint32_t ExactDbPack(int cls, const int var[4], const int neg[4], int out) {
+    uint32_t e = (uint32_t)cls | (uint32_t)out << 12 | 1u << 31;
+    for (int p = 0; p < 4; ++p) e |= (uint32_t)neg[p] << (13 + p) | (uint32_t)var[p] << (17 + 2 * p);
+    return e;
+}
+inline int ExactDbClassOf(uint32_t e) { return (int)(e & 0xFFF); }
+inline int ExactDbOutNeg(uint32_t e) { return (int)(e >> 12) & 1; }
+inline int ExactDbNeg(uint32_t e, int p) { return (int)(e >> (13 + p)) & 1; }
+inline int ExactDbVar(uint32_t e, int p) { return (int)(e >> (17 + 2 * p)) & 3; }
+
+// k 個變數的表（k < 4）重複到 16 bits
+inline uint16_t ExactDbKey(uint64_t t, int nVars) {
+    if (nVars < 4) {
+        t &= (1ULL << (1 << nVars)) - 1;
+        for (int v = nVars; v < 4; ++v) t |= t << (1 << v);
+    }
+    return (uint16_t)t;
+}
+
+inline uint64_t ExactDbChecksum(const char* p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; ++i) h = (h ^ (unsigned char)p[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+// =========================================================
+// NPN classes of 4-input functions
+// =========================================================
+
+// 從 root 出發走遍整個 class（反相 output、反相 input、交換相鄰 input），
+// 每個函數記下它到 root 的 transform；func[f] 已經有值的不再走
+inline void ExactDbOrbit(uint16_t root, int cls, std::vector<uint32_t>& func) {
+    struct Item { uint16_t f; int var[4], neg[4], out; };
+    Item it0{root, {0, 1, 2, 3}, {0, 0, 0, 0}, 0};
+    func[root] = ExactDbPack(cls, it0.var, it0.neg, it0.out);
+    std::vector<Item> stack{it0};
+    while (!stack.empty()) {
+        Item it = stack.back();
+        stack.pop_back();
+        for (int g = 0; g < 8; ++g) {
+            Item nx = it;
+            uint64_t t = it.f;
+            if (g < 4) {            // x_g 反相
+                TruthFlipVar(&t, 1, g);
+                for (int p = 0; p < 4; ++p) nx.neg[p] ^= it.var[p] == g;
+            } else if (g < 7) {     // 交換 x_v, x_{v+1}
+                int v = g - 4;
+                TruthSwapAdjacent(&t, 1, v);
+                for (int p = 0; p < 4; ++p) nx.var[p] = it.var[p] == v ? v + 1 : it.var[p] == v + 1 ? v : it.var[p];
+            } else {                // output 反相
+                t = ~t;
+                nx.out ^= 1;
+            }
+            nx.f = (uint16_t)t;
+            if (func[nx.f]) continue;
+            func[nx.f] = ExactDbPack(cls, nx.var, nx.neg, nx.out);
+            stack.push_back(nx);
+        }
+    }
+}
+
+// class 編號依最小成員遞增；roots[c] = class c 的最小成員
+inline void ExactDbClasses(std::vector<uint32_t>& func, std::vector<uint16_t>& roots) {
+    func.assign(EXACT_DB_FUNCS, 0);
+    roots.clear();
+    for (int f = 0; f < EXACT_DB_FUNCS; ++f) {
+        if (func[f]) continue;
+        ExactDbOrbit((uint16_t)f, (int)roots.size(), func);
+        roots.push_back((uint16_t)f);
+    }
+}
+
+// =========================================================
+// Reader
+// =========================================================
+
+class ExactDb {
+public:
+    static std::string DefaultPath() {
+        if (const char* p = std::getenv("AIGMIN_EXACT_DB")) if (*p) return p;
+        return "results/exactdb/npn4.db";
+    }
+
+    bool Open(const std::string& path, std::string& err) {
+        Close();
+        if (!file_.Open(path)) {
+            err = "Error: Could not open exact database " + path;
+            return false;
+        }
+        const char* p = file_.Data();
+        size_t size = file_.Size();
+        ExactDbHeader hdr;
+        if (size < sizeof(hdr)) return Fail(path, "truncated header", err);
+        std::memcpy(&hdr, p, sizeof(hdr));
+        if (std::memcmp(hdr.magic, EXACT_DB_MAGIC, sizeof(hdr.magic)) != 0) return Fail(path, "bad magic", err);
+        if (hdr.version != EXACT_DB_VERSION || hdr.nVars != (uint32_t)EXACT_DB_VARS)
+            return Fail(path, "unsupported version", err);
+        size_t need = sizeof(hdr) + sizeof(uint32_t) * EXACT_DB_FUNCS + sizeof(ExactDbClass) * hdr.nClasses +
+                      sizeof(uint16_t) * 2 * hdr.nAnds;
+        if (size != need) return Fail(path, "size mismatch", err);
+        if (ExactDbChecksum(p + sizeof(hdr), size - sizeof(hdr)) != hdr.checksum) return Fail(path, "bad checksum", err);
+        hdr_ = hdr;
+        func_ = reinterpret_cast<const uint32_t*>(p + sizeof(hdr));
+        cls_ = reinterpret_cast<const ExactDbClass*>(func_ + EXACT_DB_FUNCS);
+        fanins_ = reinterpret_cast<const uint16_t*>(cls_ + hdr.nClasses);
+        // Build 不再檢查範圍，這裡一次驗完
+        for (uint32_t c = 0; c < hdr.nClasses; ++c) {
+            const ExactDbClass& k = cls_[c];
+            if (k.nAnds > EXACT_DB_MAX_ANDS || k.firstAnd + k.nAnds > hdr.nAnds || (k.outLit >> 1) >= 5u + k.nAnds)
+                return Fail(path, "bad class record", err);
+            for (int i = 0; i < 2 * k.nAnds; ++i)
+                if ((fanins_[2 * (size_t)k.firstAnd + i] >> 1) >= 5u + (unsigned)(i / 2))
+                    return Fail(path, "bad class record", err);
+        }
+        for (int f = 0; f < EXACT_DB_FUNCS; ++f)
+            if (!(func_[f] >> 31) || (uint32_t)ExactDbClassOf(func_[f]) >= hdr.nClasses)
+                return Fail(path, "bad function record", err);
+        return true;
+    }
+
+    void Close() {
+        file_.Close();
+        func_ = nullptr;
+        cls_ = nullptr;
+        fanins_ = nullptr;
+    }
+
+    bool Valid() const { return func_ != nullptr; }
+    const ExactDbHeader& Header() const { return hdr_; }
+
+    int Cost(uint16_t f) const { return cls_[ExactDbClassOf(func_[f])].nAnds; }
+    bool Exact(uint16_t f) const { return cls_[ExactDbClassOf(func_[f])].flags & EXACT_DB_FLAG_EXACT; }
+
+    // f 接到 leaves（AIG literal；f 不依賴的 input 可以給常數 0），回傳 output literal
+    unsigned Build(uint16_t f, const unsigned leaves[4], AigStrash& strash) const {
+        uint32_t e = func_[f];
+        const ExactDbClass& c = cls_[ExactDbClassOf(e)];
+        unsigned lit[5 + EXACT_DB_MAX_ANDS];
+        lit[0] = 0;
+        for (int p = 0; p < 4; ++p) lit[1 + p] = leaves[ExactDbVar(e, p)] ^ (unsigned)ExactDbNeg(e, p);
+        auto map = [&](unsigned l) { return lit[l >> 1] ^ (l & 1u); };
+        const uint16_t* fi = fanins_ + 2 * (size_t)c.firstAnd;
+        for (int k = 0; k < c.nAnds; ++k) lit[5 + k] = strash.And(map(fi[2 * k]), map(fi[2 * k + 1]));
+        return map(c.outLit) ^ (unsigned)ExactDbOutNeg(e);
+    }
+
+private:
+    bool Fail(const std::string& path, const char* why, std::string& err) {
+        err = "Error: Invalid exact database " + path + " (" + why + ")";
+        Close();
+        return false;
+    }
+
+    MappedFile file_;
+    ExactDbHeader hdr_{};
+    const uint32_t* func_ = nullptr;
+    const ExactDbClass* cls_ = nullptr;
+    const uint16_t* fanins_ = nullptr;
+};
+
+// =========================================================
+// Writer (bin/exactdb/main)
+// =========================================================
+
+struct ExactDbImage {
+    std::vector<uint32_t> func;
+    std::vector<ExactDbClass> cls;
+    std::vector<uint16_t> fanins;
+    uint32_t maxExact = 0;
+
+    // 先寫暫存檔再 rename，讀的人不會看到寫一半的檔案
+    bool Write(const std::string& path, std::string& err) const {
+        ExactDbHeader hdr{};
+        std::memcpy(hdr.magic, EXACT_DB_MAGIC, sizeof(hdr.magic));
+        hdr.version = EXACT_DB_VERSION;
+        hdr.nVars = EXACT_DB_VARS;
+        hdr.nClasses = (uint32_t)cls.size();
+        hdr.nAnds = (uint32_t)(fanins.size() / 2);
+        hdr.maxExact = maxExact;
+        std::string body;
+        body.append((const char*)func.data(), sizeof(uint32_t) * func.size());
+        body.append((const char*)cls.data(), sizeof(ExactDbClass) * cls.size());
+        body.append((const char*)fanins.data(), sizeof(uint16_t) * fanins.size());
+        hdr.checksum = ExactDbChecksum(body.data(), body.size());
+        std::string buf((const char*)&hdr, sizeof(hdr));
+        buf += body;
+
+        std::string tmp = path + ".XXXXXX";
+        int fd = mkstemp(&tmp[0]);
+        bool ok = fd >= 0 && write(fd, buf.data(), buf.size()) == (ssize_t)buf.size();
+        if (fd >= 0) ok = (close(fd) == 0) && ok;
+        ok = ok && std::rename(tmp.c_str(), path.c_str()) == 0;
+        if (!ok) {
+            std::remove(tmp.c_str());
+            err = "Error: Could not write exact database " + path;
+        }
+        return ok;
+    }
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef COMMON_PARALLEL_H
+#define COMMON_PARALLEL_H
+
+// =========================================================
+// Minimal worker pool
+//
+// Runs fn(task) for every entry of `order` on nWorkers threads.  Workers
+// pull the next task from a shared counter, so tasks start in the given
+// order (put the expensive ones first) and a slow task never blocks the
+// queue behind it.  Results must be written to per-task slots by fn; the
+// caller then reads them in task order, so the outcome does not depend on
+// the worker count as long as fn itself is deterministic (a wall-clock
+// budget inside fn, like QM's cover_time, is not).
+// =========================================================
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+template <typename Fn>
+void ParallelForEach(const std::vector<int>& order, int nWorkers, Fn fn) {
+    nWorkers = std::max(1, std::min<int>(nWorkers, (int)order.size()));
+    if (nWorkers == 1) {
+        for (int task : order) fn(task);
+        return;
+    }
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < nWorkers; ++w) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < order.size(); i = next++) fn(order[i]);
+        });
+    }
+    for (auto& t : workers) t.join();
+}
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef COMMON_RESULT_CACHE_H
+#define COMMON_RESULT_CACHE_H
+
+// =========================================================
+// Persistent result cache
+//
+// A content-addressed store of the best AIG found so far for a function,
+// shared by every run (and every batch worker) on the machine.
+//
+// Key: a 128-bit hash of the packed truth tables after a cheap
+// semi-canonical form (ResultCacheCanon):
+//   - every output is complemented to have at most half of its minterms set
+//   - with at most RESULT_CACHE_CANON_VARS inputs, inputs are complemented
+//     and sorted by their cofactor counts (ties keep their order)
+//   - outputs are sorted by their (normalized) tables
+// Equivalent functions with ties can still end up under different keys;
+// that costs a cache miss, never a wrong result.  All of these transforms
+// are free on an AIG (renumbered PIs, complemented edges), so an entry is
+// stored in canonical form and mapped back on lookup.
+//
+// Value: <dir>/<key>.aig, a binary AIGER file with the gate count in its
+// header and a comment line with the provenance.  Entries are replaced
+// under an flock on <key>.lock, and only if the new AIG is smaller.  The
+// file is written to a temporary name and renamed, so readers never see
+// a partial file.  Callers still verify what they load.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "common/aiger.h"
+#include "common/mapped_file.h"
+#include "common/truth_table.h"
+
+const int RESULT_CACHE_CANON_VARS = 16;  // 輸入排列 / 反相正規化的上限（2^16 個 minterm 重排）
+const char* const RESULT_CACHE_MARK = "aigmin-cache ";
+
+// =========================================================
+// Canonical form
+// =========================================================
+
+struct ResultCacheCanon {
+    std::vector<int> inPerm;    // canonical input p = 原本的 input inPerm[p]
+    std::vector<char> inNeg;    // 原本的 input i 是否反相
+    std::vector<int> outPerm;   // canonical output q = 原本的 output outPerm[q]
+    std::vector<char> outNeg;   // 原本的 output j 是否反相
+    uint64_t hash[2] = {0, 0};
+
+    std::string Key() const {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%016llx%016llx", (unsigned long long)hash[0], (unsigned long long)hash[1]);
+        return buf;
+    }
+};
+
+inline uint64_t ResultCacheMix(uint64_t h, uint64_t x) {
+    h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    return h ^ (h >> 29);
+}
+
+inline void ResultCacheCanonicalize(const TruthTable& tt, ResultCacheCanon& canon) {
+    int n = tt.nVars, nOuts = tt.nOuts, nWords = tt.nWords;
+    uint64_t mask = n >= 6 ? ~0ULL : (1ULL << tt.nBits) - 1;
+    canon.inPerm.resize(n);
+    std::iota(canon.inPerm.begin(), canon.inPerm.end(), 0);
+    canon.inNeg.assign(n, 0);
+    canon.outNeg.assign(nOuts, 0);
+
+    // 1. output 反相：onset 不超過一半
+    TruthTable work = tt;
+    for (int j = 0; j < nOuts; ++j) {
+        if (2 * TruthCountOnes(tt.Output(j), nWords) <= tt.nBits) continue;
+        canon.outNeg[j] = 1;
+        for (int w = 0; w < nWords; ++w) work.Output(j)[w] = ~work.Output(j)[w] & mask;
+    }
+
+    // 2. input 反相與排序（只在重排便宜時）
+    if (n <= RESULT_CACHE_CANON_VARS) {
+        // c1[i * nOuts + j] = output j 在 x_i = 1 的 cofactor 中 1 的個數
+        std::vector<uint64_t> c1((size_t)n * nOuts, 0), c0((size_t)n * nOuts, 0);
+        for (int j = 0; j < nOuts; ++j) {
+            const uint64_t* f = work.Output(j);
+            for (uint64_t m = 0; m < tt.nBits; ++m) {
+                if (!((f[m >> 6] >> (m & 63)) & 1)) continue;
+                for (int i = 0; i < n; ++i) ((m >> i) & 1 ? c1 : c0)[(size_t)i * nOuts + j]++;
+            }
+        }
+        std::vector<std::vector<uint64_t>> sig(n);
+        for (int i = 0; i < n; ++i) {
+            uint64_t s1 = 0, s0 = 0;
+            for (int j = 0; j < nOuts; ++j) {
+                s1 += c1[(size_t)i * nOuts + j];
+                s0 += c0[(size_t)i * nOuts + j];
+            }
+            canon.inNeg[i] = s1 > s0;
+            // 反相之後的 x_i = 1 cofactor；per-output 的部分排序後才與 output 順序無關
+            std::vector<uint64_t> per(nOuts);
+            for (int j = 0; j < nOuts; ++j) per[j] = (canon.inNeg[i] ? c0 : c1)[(size_t)i * nOuts + j];
+            std::sort(per.begin(), per.end());
+            sig[i].push_back(std::min(s0, s1));
+            sig[i].insert(sig[i].end(), per.begin(), per.end());
+        }
+        std::stable_sort(canon.inPerm.begin(), canon.inPerm.end(), [&](int a, int b) { return sig[a] < sig[b]; });
+
+        bool identity = true;
+        for (int p = 0; p < n; ++p) identity = identity && canon.inPerm[p] == p && !canon.inNeg[p];
+        if (!identity) {
+            // g(y) = f(x)，x_{inPerm[p]} = y_p ^ inNeg[inPerm[p]]
+            TruthTable perm = work;
+            std::fill(perm.words.begin(), perm.words.end(), 0);
+            uint64_t flip = 0;
+            for (int i = 0; i < n; ++i)
+                if (canon.inNeg[i]) flip |= 1ULL << i;
+            for (uint64_t y = 0; y < tt.nBits; ++y) {
+                uint64_t x = 0;
+                for (int p = 0; p < n; ++p) x |= ((y >> p) & 1) << canon.inPerm[p];
+                x ^= flip;
+                for (int j = 0; j < nOuts; ++j)
+                    if ((work.Output(j)[x >> 6] >> (x & 63)) & 1) perm.Output(j)[y >> 6] |= 1ULL << (y & 63);
+            }
+            work = std::move(perm);
+        }
+    }
+
+    // 3. output 排序
+    canon.outPerm.resize(nOuts);
+    std::iota(canon.outPerm.begin(), canon.outPerm.end(), 0);
+    std::stable_sort(canon.outPerm.begin(), canon.outPerm.end(), [&](int a, int b) {
+        return std::lexicographical_compare(work.Output(a), work.Output(a) + nWords, work.Output(b), work.Output(b) + nWords);
+    });
+
+    // 4. hash（兩個不同的起始值）
+    canon.hash[0] = ResultCacheMix(0x243f6a8885a308d3ULL, ((uint64_t)n << 32) | (uint64_t)nOuts);
+    canon.hash[1] = ResultCacheMix(0x13198a2e03707344ULL, ((uint64_t)nOuts << 32) | (uint64_t)n);
+    for (int q = 0; q < nOuts; ++q) {
+        const uint64_t* f = work.Output(canon.outPerm[q]);
+        for (int w = 0; w < nWords; ++w) {
+            canon.hash[0] = ResultCacheMix(canon.hash[0], f[w]);
+            canon.hash[1] = ResultCacheMix(canon.hash[1] ^ (uint64_t)w, f[w]);
+        }
+    }
+}
+
+// PI i 換成 piLit[i]（結果的 PI 仍是 1..nPis），output q = g.outputs[outSrc[q]] ^ outNeg[q]
+inline void ResultCacheRemap(const AigGraph& g, const std::vector<unsigned>& piLit, const std::vector<int>& outSrc,
+                             const std::vector<char>& outNeg, AigGraph& out) {
+    out = AigGraph();
+    out.nPis = g.nPis;
+    auto lit = [&](unsigned l) {
+        unsigned v = l >> 1;
+        return (v >= 1 && (int)v <= g.nPis) ? piLit[v - 1] ^ (l & 1u) : l;
+    };
+    for (int k = 0; k < g.AndNum(); ++k) {
+        unsigned f0 = lit(g.fanin0[k]), f1 = lit(g.fanin1[k]);
+        out.fanin0.push_back(std::max(f0, f1));
+        out.fanin1.push_back(std::min(f0, f1));
+    }
+    for (size_t q = 0; q < outSrc.size(); ++q) out.outputs.push_back(lit(g.outputs[outSrc[q]]) ^ (unsigned)outNeg[q]);
+}
+
+inline void ResultCacheToCanonical(const AigGraph& g, const ResultCacheCanon& canon, AigGraph& out) {
+    int n = (int)canon.inPerm.size();
+    std::vector<unsigned> piLit(n);
+    for (int p = 0; p < n; ++p) piLit[canon.inPerm[p]] = 2u * (unsigned)(1 + p) ^ (unsigned)canon.inNeg[canon.inPerm[p]];
+    std::vector<char> neg(canon.outPerm.size());
+    for (size_t q = 0; q < neg.size(); ++q) neg[q] = canon.outNeg[canon.outPerm[q]];
+    ResultCacheRemap(g, piLit, canon.outPerm, neg, out);
+}
+
+inline void ResultCacheFromCanonical(const AigGraph& g, const ResultCacheCanon& canon, AigGraph& out) {
+    int n = (int)canon.inPerm.size();
+    std::vector<unsigned> piLit(n);
+    for (int p = 0; p < n; ++p) piLit[p] = 2u * (unsigned)(1 + canon.inPerm[p]) ^ (unsigned)canon.inNeg[canon.inPerm[p]];
+    std::vector<int> src(canon.outPerm.size());
+    for (size_t q = 0; q < src.size(); ++q) src[canon.outPerm[q]] = (int)q;
+    ResultCacheRemap(g, piLit, src, canon.outNeg, out);
+}
+
+// =========================================================
+// Store
+// =========================================================
+
+struct ResultCacheEntry {
+    int gates = -1;
+    std::string provenance;
+};
+
+class ResultCache {
+public:
+    // $AIGMIN_CACHE 優先，否則 results/cache
+    static std::string DefaultDir() {
+        if (const char* p = std::getenv("AIGMIN_CACHE")) if (*p) return p;
+        return "results/cache";
+    }
+
+    bool Open(const std::string& dir, std::string& err) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        if (!std::filesystem::is_directory(dir)) {
+            err = "Error: Could not create cache directory " + dir;
+            return false;
+        }
+        dir_ = dir;
+        return true;
+    }
+
+    bool Valid() const { return !dir_.empty(); }
+    const std::string& Dir() const { return dir_; }
+
+    // 命中時 aig 已換回 tt 的介面；回傳 false = 沒有（或讀不到）
+    bool Lookup(const TruthTable& tt, AigGraph& aig, ResultCacheEntry& entry) const {
+        if (!Valid()) return false;
+        ResultCacheCanon canon;
+        ResultCacheCanonicalize(tt, canon);
+        std::string file = EntryFile(canon);
+        AigGraph stored;
+        std::string err;
+        if (!AigerRead(file, stored, err) || stored.nPis != tt.nVars || (int)stored.outputs.size() != tt.nOuts ||
+            stored.nLatches)
+            return false;
+        entry.gates = stored.AndNum();
+        entry.provenance = ReadProvenance(file);
+        ResultCacheFromCanonical(stored, canon, aig);
+        return true;
+    }
+
+    // aig（已驗證）比快取中的小才寫入；pImproved 回報是否真的更新
+    bool Store(const TruthTable& tt, const AigGraph& aig, const std::string& provenance, std::string& err,
+               bool* pImproved = nullptr) {
+        if (pImproved) *pImproved = false;
+        if (!Valid()) {
+            err = "Error: cache is not open";
+            return false;
+        }
+        ResultCacheCanon canon;
+        ResultCacheCanonicalize(tt, canon);
+        std::string file = EntryFile(canon);
+
+        // 同一個 key 的「比較 + 取代」在 flock 之下進行
+        std::string lockFile = dir_ + "/" + canon.Key() + ".lock";
+        int lockFd = open(lockFile.c_str(), O_RDWR | O_CREAT, 0644);
+        if (lockFd < 0 || flock(lockFd, LOCK_EX) != 0) {
+            if (lockFd >= 0) close(lockFd);
+            err = "Error: Could not lock " + lockFile;
+            return false;
+        }
+        bool ok = true;
+        AigerHeader hdr;
+        std::string herr;
+        if (!AigerReadHeader(file, hdr, herr) || (int)hdr.A > aig.AndNum()) {
+            AigGraph canonical;
+            ResultCacheToCanonical(aig, canon, canonical);
+            std::string buf;
+            ok = AigerToBuffer(canonical, buf, err);
+            if (ok) {
+                // AIGER comment section：provenance 一行（換行換成空白）
+                std::string line = provenance;
+                std::replace(line.begin(), line.end(), '\n', ' ');
+                buf += "c\n";
+                buf += RESULT_CACHE_MARK + line + "\n";
+                std::string tmp = dir_ + "/." + canon.Key() + ".XXXXXX";
+                int fd = mkstemp(&tmp[0]);
+                ok = fd >= 0 && write(fd, buf.data(), buf.size()) == (ssize_t)buf.size();
+                if (fd >= 0) ok = (close(fd) == 0) && ok;
+                ok = ok && std::rename(tmp.c_str(), file.c_str()) == 0;
+                if (!ok) {
+                    std::remove(tmp.c_str());
+                    err = "Error: Could not write cache entry " + file;
+                } else if (pImproved) {
+                    *pImproved = true;
+                }
+            }
+        }
+        flock(lockFd, LOCK_UN);
+        close(lockFd);
+        return ok;
+    }
+
+    // provenance 的標準格式
+    static std::string Provenance(const std::string& tool, const std::string& source, int gates) {
+        char when[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        return "tool=" + tool + " source=" + source + " gates=" + std::to_string(gates) + " time=" + when;
+    }
+
+private:
+    std::string dir_;
+
+    std::string EntryFile(const ResultCacheCanon& canon) const { return dir_ + "/" + canon.Key() + ".aig"; }
+
+    static std::string ReadProvenance(const std::string& file) {
+        MappedFile mf;
+        if (!mf.Open(file)) return "";
+        std::string data(mf.Data(), mf.Size());
+        size_t pos = data.rfind(std::string("c\n") + RESULT_CACHE_MARK);
+        if (pos == std::string::npos) return "";
+        pos += 2 + std::string(RESULT_CACHE_MARK).size();
+        size_t end = data.find('\n', pos);
+        return data.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef COMMON_SCRATCH_H
+#define COMMON_SCRATCH_H
+
+// =========================================================
+// Per-process scratch workspace
+//
+// Every temporary file a driver creates lives in one private directory
+// made with mkdtemp, so parallel workers can never pick the same name.
+// The directory is placed on RAM-backed storage when possible:
+//   $AIGMIN_SCRATCH  (explicit override)
+//   /dev/shm         (tmpfs on Linux)
+//   $TMPDIR, /tmp
+// The directory and everything in it is removed by the destructor, and
+// also at exit() so the early-exit error paths of the drivers do not
+// leave anything behind.
+// =========================================================
+
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+class ScratchDir {
+public:
+    ScratchDir() = default;
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+    ~ScratchDir() { Remove(); }
+
+    // tag 只用來讓目錄名稱好辨認，例如 "simplifier"
+    bool Create(const std::string& tag, std::string& err) {
+        Remove();
+        for (const std::string& base : Candidates()) {
+            std::string templ = base + "/aigmin_" + tag + "_" + std::to_string(::getpid()) + "_XXXXXX";
+            if (::mkdtemp(&templ[0])) {
+                path_ = templ;
+                Registry().Add(path_);
+                return true;
+            }
+        }
+        err = "Error: Could not create a scratch directory (tried $AIGMIN_SCRATCH, /dev/shm, $TMPDIR, /tmp)";
+        return false;
+    }
+
+    bool Valid() const { return !path_.empty(); }
+    const std::string& Path() const { return path_; }
+
+    // 工作區內的檔案路徑（不建立檔案）
+    std::string File(const std::string& name) const { return path_ + "/" + name; }
+
+    // 工作區內的子目錄（會建立）
+    std::string SubDir(const std::string& name) const {
+        std::string dir = File(name);
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        return dir;
+    }
+
+    void Remove() {
+        if (path_.empty()) return;
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+        Registry().Erase(path_);
+        path_.clear();
+    }
+
+private:
+    std::string path_;
+
+    static std::vector<std::string> Candidates() {
+        std::vector<std::string> dirs;
+        if (const char* p = std::getenv("AIGMIN_SCRATCH")) if (*p) dirs.push_back(p);
+        dirs.push_back("/dev/shm");
+        if (const char* p = std::getenv("TMPDIR")) if (*p) dirs.push_back(p);
+        dirs.push_back("/tmp");
+        return dirs;
+    }
+
+    // 還存在的工作區；exit() 不會跑 destructor，由 atexit 補刪
+    struct LiveSet {
+        std::mutex mutex;
+        std::set<std::string> paths;
+        bool hooked = false;
+
+        void Add(const std::string& p) {
+            std::lock_guard<std::mutex> lock(mutex);
+            paths.insert(p);
+            if (!hooked) {
+                std::atexit(&ScratchDir::CleanupAtExit);
+                hooked = true;
+            }
+        }
+        void Erase(const std::string& p) {
+            std::lock_guard<std::mutex> lock(mutex);
+            paths.erase(p);
+        }
+    };
+
+    static LiveSet& Registry() {
+        static LiveSet* s = new LiveSet();  // 刻意不釋放，atexit 時仍可使用
+        return *s;
+    }
+
+    static void CleanupAtExit() {
+        LiveSet& live = Registry();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        for (const std::string& p : live.paths) {
+            std::error_code ec;
+            std::filesystem::remove_all(p, ec);
+        }
+        live.paths.clear();
+    }
+};
+
+#endif
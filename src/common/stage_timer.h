@@ -0,0 +1,107 @@
+#ifndef COMMON_STAGE_TIMER_H
+#define COMMON_STAGE_TIMER_H
+
+// =========================================================
+// Per-stage resource accounting (read by the benchmark harness, src/bench)
+//
+// A driver marks its stages with a scoped StageTimer (or ends one early
+// with Stop()):
+//     { StageTimer t("parse"); LoadTruthFile(...); }
+// When $AIGMIN_STAGE_LOG names a file, every finished stage appends a line
+//     stage=<name> wall=<s> cpu=<s> rss_kb=<kB>
+//   wall    monotonic clock
+//   cpu     user + sys of the process (all threads), plus the children
+//           reaped during the stage (simplifier binary, timeout(1), ...)
+//   rss_kb  peak resident set so far (ru_maxrss of the process or of its
+//           largest child, whichever is larger); it never goes down
+// Without the variable a StageTimer does nothing.  Stages are marked on
+// the main thread; a stage started inside another one is charged to the
+// outer stage only, so a helper (AbcSynthesizeTruth: build / abc) can mark
+// its own stages and still be called from inside a caller's stage.
+// =========================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+inline double StageCpuSeconds(const struct rusage& ru) {
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+}
+
+class StageTimer {
+public:
+    explicit StageTimer(const std::string& name) : name_(name) {
+        if (LogPath().empty()) return;
+        enabled_ = true;
+        if (Depth()++ > 0) return;
+        active_ = true;
+        start_ = std::chrono::steady_clock::now();
+        cpu_ = Cpu();
+    }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    ~StageTimer() { Stop(); }
+
+    // 提早結束這個 stage（之後的 Stop / 解構不會再記錄）
+    void Stop() {
+        if (!enabled_) return;
+        enabled_ = false;
+        --Depth();
+        if (active_) Write();
+    }
+
+    // $AIGMIN_STAGE_LOG，只讀一次
+    static const std::string& LogPath() {
+        static const std::string path = [] {
+            const char* p = std::getenv("AIGMIN_STAGE_LOG");
+            return std::string(p ? p : "");
+        }();
+        return path;
+    }
+
+private:
+    static int& Depth() {
+        static int depth = 0;
+        return depth;
+    }
+
+    static double Cpu() {
+        struct rusage self, children;
+        getrusage(RUSAGE_SELF, &self);
+        getrusage(RUSAGE_CHILDREN, &children);
+        return StageCpuSeconds(self) + StageCpuSeconds(children);
+    }
+
+    void Write() const {
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        double cpu = std::max(0.0, Cpu() - cpu_);
+        struct rusage self, children;
+        getrusage(RUSAGE_SELF, &self);
+        getrusage(RUSAGE_CHILDREN, &children);
+        long rssKb = std::max(self.ru_maxrss, children.ru_maxrss);
+        char line[256];
+        int n = std::snprintf(line, sizeof(line), "stage=%s wall=%.6f cpu=%.6f rss_kb=%ld\n", name_.c_str(), wall,
+                              cpu, rssKb);
+        if (n <= 0 || n >= (int)sizeof(line)) return;
+        // O_APPEND + 一次 write：同一個 log 的多個行程不會把行寫亂
+        int fd = open(LogPath().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return;
+        ssize_t w = ::write(fd, line, (size_t)n);
+        (void)w;
+        close(fd);
+    }
+
+    std::string name_;
+    bool enabled_ = false;
+    bool active_ = false;
+    std::chrono::steady_clock::time_point start_;
+    double cpu_ = 0;
+};
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef COMMON_TRUTH_NPN_H
+#define COMMON_TRUTH_NPN_H
+
+// =========================================================
+// NPN classes of the outputs of a truth table
+//
+// Two outputs are in the same class when one is the other up to output
+// negation, input negation and input permutation.  Each output gets a
+// semi-canonical form from word-level kernels on the packed table
+// (truth_table.h layout):
+//   1. complement the output if more than half of its minterms are 1
+//   2. flip every input whose positive cofactor has more 1s
+//   3. bubble-sort the inputs by positive-cofactor count (adjacent swaps)
+// Ties are left in place, so two equivalent outputs may still land in
+// different classes (a missed merge, never a wrong one).  Outputs whose
+// canonical tables are equal share a class.  The first output of a class
+// is its representative, and every output records how to rebuild it from
+// its representative: which literal feeds each representative input, and
+// whether the output is complemented.
+//
+// Drivers synthesize only the representatives (TruthNpnRepresentatives)
+// and rebuild the full AIG with AigNpnExpand.  Equal and complemented
+// outputs cost nothing.  Permuted ones get a rewired copy of the cone.
+// =========================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "common/aig_window.h"
+#include "common/aiger.h"
+#include "common/truth_table.h"
+
+// =========================================================
+// Kernels
+// =========================================================
+
+// 變數 v 反相：f(x) -> f(x ^ e_v)
+inline void TruthFlipVar(uint64_t* f, int nWords, int v) {
+    if (v < 6) {
+        int s = 1 << v;
+        uint64_t m = s_TruthVar6[v];
+        for (int w = 0; w < nWords; ++w) f[w] = ((f[w] & m) >> s) | ((f[w] & ~m) << s);
+        return;
+    }
+    int step = 1 << (v - 6);
+    for (int w = 0; w < nWords; w += 2 * step)
+        for (int i = 0; i < step; ++i) std::swap(f[w + i], f[w + step + i]);
+}
+
+// 交換相鄰變數 v 與 v + 1
+inline void TruthSwapAdjacent(uint64_t* f, int nWords, int v) {
+    static const uint64_t s_Masks[5][3] = {
+        {0x9999999999999999ULL, 0x2222222222222222ULL, 0x4444444444444444ULL},
+        {0xC3C3C3C3C3C3C3C3ULL, 0x0C0C0C0C0C0C0C0CULL, 0x3030303030303030ULL},
+        {0xF00FF00FF00FF00FULL, 0x00F000F000F000F0ULL, 0x0F000F000F000F00ULL},
+        {0xFF0000FFFF0000FFULL, 0x0000FF000000FF00ULL, 0x00FF000000FF0000ULL},
+        {0xFFFF00000000FFFFULL, 0x00000000FFFF0000ULL, 0x0000FFFF00000000ULL}};
+    if (v < 5) {
+        int s = 1 << v;
+        const uint64_t* m = s_Masks[v];
+        for (int w = 0; w < nWords; ++w) f[w] = (f[w] & m[0]) | ((f[w] & m[1]) << s) | ((f[w] & m[2]) >> s);
+        return;
+    }
+    if (v == 5) {
+        for (int w = 0; w < nWords; w += 2) {
+            uint64_t lo = f[w], hi = f[w + 1];
+            f[w] = (lo & 0x00000000FFFFFFFFULL) | (hi << 32);
+            f[w + 1] = (lo >> 32) | (hi & 0xFFFFFFFF00000000ULL);
+        }
+        return;
+    }
+    int step = 1 << (v - 6);
+    for (int w = 0; w < nWords; w += 4 * step)
+        for (int i = 0; i < step; ++i) std::swap(f[w + step + i], f[w + 2 * step + i]);
+}
+
+// x_v = 1 的 minterm 中 1 的個數
+inline uint64_t TruthCountOnes1(const uint64_t* f, int nWords, int v) {
+    uint64_t n = 0;
+    if (v < 6) {
+        for (int w = 0; w < nWords; ++w) n += (uint64_t)__builtin_popcountll(f[w] & s_TruthVar6[v]);
+    } else {
+        for (int w = 0; w < nWords; ++w)
+            if ((w >> (v - 6)) & 1) n += (uint64_t)__builtin_popcountll(f[w]);
+    }
+    return n;
+}
+
+// =========================================================
+// Semi-canonical form
+// =========================================================
+
+// canonical c(z) = f(x) ^ outNeg，其中 x_{var[p]} = z_p ^ neg[p]
+struct TruthNpnTransform {
+    std::vector<int> var;
+    std::vector<char> neg;
+    bool outNeg = false;
+};
+
+inline void TruthNpnCanonicize(const uint64_t* f, int nVars, std::vector<uint64_t>& t, TruthNpnTransform& tr) {
+    int nWords = TruthWordNum(nVars);
+    uint64_t nBits = 1ULL << nVars;
+    uint64_t mask = nVars >= 6 ? ~0ULL : (1ULL << nBits) - 1;
+    t.assign(f, f + nWords);
+    tr.var.resize(nVars);
+    std::iota(tr.var.begin(), tr.var.end(), 0);
+    tr.neg.assign(nVars, 0);
+    tr.outNeg = false;
+
+    uint64_t total = TruthCountOnes(t.data(), nWords);
+    if (2 * total > nBits) {
+        for (uint64_t& w : t) w = ~w & mask;
+        total = nBits - total;
+        tr.outNeg = true;
+    }
+    std::vector<uint64_t> c1(nVars);
+    for (int p = 0; p < nVars; ++p) {
+        c1[p] = TruthCountOnes1(t.data(), nWords, p);
+        if (2 * c1[p] > total) {
+            TruthFlipVar(t.data(), nWords, p);
+            tr.neg[p] = 1;
+            c1[p] = total - c1[p];
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int p = 0; p + 1 < nVars; ++p) {
+            if (c1[p] <= c1[p + 1]) continue;
+            TruthSwapAdjacent(t.data(), nWords, p);
+            std::swap(c1[p], c1[p + 1]);
+            std::swap(tr.var[p], tr.var[p + 1]);
+            std::swap(tr.neg[p], tr.neg[p + 1]);
+            changed = true;
+        }
+    }
+}
+
+// =========================================================
+// Classes
+// =========================================================
+
+struct TruthNpnClasses {
+    int nClasses = 0;
+    std::vector<int> reps;                  // class -> 代表的 output index
+    std::vector<int> cls;                   // output -> class
+    std::vector<std::vector<unsigned>> inputs;  // output j：代表的 input i 接 AIG literal inputs[j][i]
+    std::vector<char> outNeg;               // output j = 代表 ^ outNeg[j]
+
+    bool Reduced() const { return nClasses < (int)cls.size(); }
+};
+
+inline void TruthNpnClassify(const TruthTable& tt, TruthNpnClasses& npn) {
+    int n = tt.nVars;
+    npn = TruthNpnClasses();
+    npn.cls.assign(tt.nOuts, -1);
+    npn.inputs.assign(tt.nOuts, std::vector<unsigned>(n));
+    npn.outNeg.assign(tt.nOuts, 0);
+
+    std::vector<std::vector<uint64_t>> canon;      // class -> canonical table
+    std::vector<TruthNpnTransform> repTr;          // class -> 代表的 transform
+    std::unordered_map<uint64_t, std::vector<int>> byHash;
+    std::vector<uint64_t> t;
+    TruthNpnTransform tr;
+    for (int j = 0; j < tt.nOuts; ++j) {
+        TruthNpnCanonicize(tt.Output(j), n, t, tr);
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (uint64_t w : t) h = (h ^ w) * 0x100000001b3ULL ^ (h >> 29);
+        int c = -1;
+        for (int k : byHash[h])
+            if (canon[k] == t) { c = k; break; }
+        if (c < 0) {
+            c = npn.nClasses++;
+            canon.push_back(t);
+            repTr.push_back(tr);
+            npn.reps.push_back(j);
+            byHash[h].push_back(c);
+        }
+        npn.cls[j] = c;
+        // f_j(x) = f_r(x') ^ or ^ oj，代表的 input var_r[p] 接 x_{var_j[p]} ^ neg_j[p] ^ neg_r[p]
+        const TruthNpnTransform& rt = repTr[c];
+        for (int p = 0; p < n; ++p)
+            npn.inputs[j][rt.var[p]] = 2u * (unsigned)(1 + tr.var[p]) ^ (unsigned)(tr.neg[p] ^ rt.neg[p]);
+        npn.outNeg[j] = (char)(tr.outNeg ^ rt.outNeg);
+    }
+}
+
+// 只含代表的真值表（output c = 第 c 個 class 的代表）
+inline void TruthNpnRepresentatives(const TruthTable& tt, const TruthNpnClasses& npn, TruthTable& reps) {
+    reps = TruthTable();
+    reps.nVars = tt.nVars;
+    reps.nOuts = npn.nClasses;
+    reps.nWords = tt.nWords;
+    reps.nBits = tt.nBits;
+    reps.words.reserve((size_t)reps.nOuts * reps.nWords);
+    for (int r : npn.reps) reps.words.insert(reps.words.end(), tt.Output(r), tt.Output(r) + tt.nWords);
+}
+
+// 代表的 AIG（每個 class 一個 output）-> 所有 output；相同的 input 接法只複製一次，
+// 結果經過 strash，所以相等或反相的 output 不會多出任何 AND
+inline void AigNpnExpand(const AigGraph& repAig, const TruthNpnClasses& npn, AigGraph& out) {
+    AigStrash strash(repAig.nPis);
+    std::map<std::vector<unsigned>, std::vector<unsigned>> copies;  // input 接法 -> repAig 每個 var 的 literal
+    std::vector<unsigned> outputs;
+    for (size_t j = 0; j < npn.cls.size(); ++j) {
+        auto it = copies.find(npn.inputs[j]);
+        if (it == copies.end()) {
+            std::vector<unsigned> lit(repAig.MaxVar() + 1, 0);
+            for (int i = 0; i < repAig.nPis; ++i) lit[1 + i] = npn.inputs[j][i];
+            auto map = [&](unsigned l) { return lit[l >> 1] ^ (l & 1u); };
+            for (int k = 0; k < repAig.AndNum(); ++k)
+                lit[repAig.AndLit(k) >> 1] = strash.And(map(repAig.fanin0[k]), map(repAig.fanin1[k]));
+            it = copies.emplace(npn.inputs[j], std::move(lit)).first;
+        }
+        unsigned l = repAig.outputs[npn.cls[j]];
+        outputs.push_back((it->second[l >> 1] ^ (l & 1u)) ^ (unsigned)npn.outNeg[j]);
+    }
+    strash.Finish(outputs, out);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef COMMON_TRUTH_SUPPORT_H
+#define COMMON_TRUTH_SUPPORT_H
+
+// =========================================================
+// Functional support of truth-table outputs
+//
+// An output depends on x_v iff its two cofactors on x_v differ.  The test
+// is word-wise on the packed table (truth_table.h layout): for v < 6 the
+// cofactors sit in the same word under s_TruthVar6[v], for v >= 6 they are
+// word blocks 2^(v-6) apart.
+//
+// TruthShrink projects an output onto its support: the support variables
+// are moved down to x_0..x_{k-1} with adjacent swaps (the others do not
+// matter, so their order is irrelevant) and the first 2^k bits are the
+// projected table.  A result over the projected inputs is lifted back by
+// renaming local input p to support[p].
+// =========================================================
+
+#include <cstdint>
+#include <vector>
+
+#include "common/truth_npn.h"
+#include "common/truth_table.h"
+
+// f 是否真的依賴 x_v（兩個 cofactor 是否不同）
+inline bool TruthHasVar(const uint64_t* f, int nWords, int v) {
+    if (v < 6) {
+        int s = 1 << v;
+        uint64_t m = s_TruthVar6[v];
+        for (int w = 0; w < nWords; ++w)
+            if (((f[w] & m) >> s) != (f[w] & ~m)) return true;
+        return false;
+    }
+    int step = 1 << (v - 6);
+    for (int w = 0; w < nWords; w += 2 * step)
+        for (int i = 0; i < step; ++i)
+            if (f[w + i] != f[w + step + i]) return true;
+    return false;
+}
+
+// 依賴的變數（遞增）
+inline std::vector<int> TruthSupport(const uint64_t* f, int nVars) {
+    std::vector<int> support;
+    int nWords = TruthWordNum(nVars);
+    for (int v = 0; v < nVars; ++v)
+        if (TruthHasVar(f, nWords, v)) support.push_back(v);
+    return support;
+}
+
+// 所有 output 依賴變數的聯集（遞增）
+inline std::vector<int> TruthSupportUnion(const TruthTable& tt) {
+    std::vector<char> used(tt.nVars, 0);
+    for (int j = 0; j < tt.nOuts; ++j)
+        for (int v = 0; v < tt.nVars; ++v)
+            if (!used[v] && TruthHasVar(tt.Output(j), tt.nWords, v)) used[v] = 1;
+    std::vector<int> support;
+    for (int v = 0; v < tt.nVars; ++v)
+        if (used[v]) support.push_back(v);
+    return support;
+}
+
+// f 投影到 support（遞增、包含 f 的所有依賴變數）：
+// out 是 support.size() 個變數的表，local x_p = 原本的 x_{support[p]}
+inline void TruthShrink(const uint64_t* f, int nVars, const std::vector<int>& support, std::vector<uint64_t>& out) {
+    int nWords = TruthWordNum(nVars);
+    int k = (int)support.size();
+    std::vector<uint64_t> t(f, f + nWords);
+    // support 遞增，所以 support[p] 與 p 之間全是不依賴的變數
+    for (int p = 0; p < k; ++p)
+        for (int v = support[p]; v > p; --v) TruthSwapAdjacent(t.data(), nWords, v - 1);
+    out.assign(t.begin(), t.begin() + TruthWordNum(k));
+    if (k < 6) out[0] &= (1ULL << (1 << k)) - 1;
+}
+
+// 整張表投影到同一組 support
+inline void TruthProject(const TruthTable& tt, const std::vector<int>& support, TruthTable& out) {
+    int k = (int)support.size();
+    out = TruthTable();
+    out.nVars = k;
+    out.nOuts = tt.nOuts;
+    out.nWords = TruthWordNum(k);
+    out.nBits = 1ULL << k;
+    out.words.reserve((size_t)out.nOuts * out.nWords);
+    std::vector<uint64_t> t;
+    for (int j = 0; j < tt.nOuts; ++j) {
+        TruthShrink(tt.Output(j), tt.nVars, support, t);
+        out.words.insert(out.words.end(), t.begin(), t.end());
+    }
+}
+
+#endif
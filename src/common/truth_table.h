@@ -0,0 +1,490 @@
+#ifndef COMMON_TRUTH_TABLE_H
+#define COMMON_TRUTH_TABLE_H
+
+// =========================================================
+// Shared .truth loader
+//
+// A .truth file holds one function per line, written MSB-first: the first
+// character is minterm 2^n - 1 and the last one is minterm 0 (the order ABC's
+// read_truth expects).  The file is memory-mapped and every line is parsed
+// straight into packed 64-bit words, so a driver never holds the ASCII text.
+// The same loader reads the binary container (.tbin, below), which is the
+// packed layout itself plus checksums.
+//
+// Packed layout: bit (m & 63) of word (m >> 6) is the value of minterm m,
+// and input x_i is bit i of the minterm index.  Outputs with fewer than
+// 6 inputs still occupy one word; the unused high bits are always zero.
+// =========================================================
+
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/mapped_file.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+struct TruthTable {
+    int nVars = 0;
+    int nOuts = 0;
+    int nWords = 0;              // words per output
+    uint64_t nBits = 0;          // 2^nVars
+    std::vector<uint64_t> words; // nOuts * nWords
+
+    uint64_t* Output(int j) { return words.data() + (size_t)j * nWords; }
+    const uint64_t* Output(int j) const { return words.data() + (size_t)j * nWords; }
+
+    bool Get(int j, uint64_t m) const {
+        return (Output(j)[m >> 6] >> (m & 63)) & 1;
+    }
+};
+
+// =========================================================
+// Bit helpers
+// =========================================================
+
+// Word masks of x_0..x_5 (bit m set iff bit v of m is set)
+static const uint64_t s_TruthVar6[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+inline uint64_t TruthBitReverse64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(x);
+}
+
+inline uint64_t TruthCountOnes(const uint64_t* pWords, int nWords) {
+    uint64_t n = 0;
+    for (int w = 0; w < nWords; ++w) n += (uint64_t)__builtin_popcountll(pWords[w]);
+    return n;
+}
+
+inline int TruthWordNum(int nVars) { return nVars <= 6 ? 1 : 1 << (nVars - 6); }
+
+// 64 ASCII characters -> 64 bits (bit i = p[i] == '1').
+// `bad` collects every byte that is neither '0' nor '1'.
+inline uint64_t TruthPack64(const char* p, uint64_t& bad) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i one  = _mm256_set1_epi8(1);
+    const __m256i hi   = _mm256_set1_epi8((char)0xFE);
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    uint64_t okA = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(a, hi), zero));
+    uint64_t okB = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(b, hi), zero));
+    uint64_t bitA = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(_mm256_and_si256(a, one), 7));
+    uint64_t bitB = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(_mm256_and_si256(b, one), 7));
+    bad |= ~(okA | (okB << 32));
+    return bitA | (bitB << 32);
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i one  = _mm_set1_epi8(1);
+    const __m128i hi   = _mm_set1_epi8((char)0xFE);
+    uint64_t ok = 0, bits = 0;
+    for (int k = 0; k < 4; ++k) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        ok   |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, hi), zero)) << (16 * k);
+        bits |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_slli_epi16(_mm_and_si128(v, one), 7)) << (16 * k);
+    }
+    bad |= ~ok;
+    return bits;
+#else
+    uint64_t bits = 0;
+    for (int i = 0; i < 64; ++i) {
+        unsigned char c = (unsigned char)p[i];
+        if ((c & 0xFE) != '0') bad = 1;
+        bits |= (uint64_t)(c & 1) << i;
+    }
+    return bits;
+#endif
+}
+
+// Parses L (= 2^n) MSB-first characters into packed words.
+inline bool TruthParseLine(const char* p, uint64_t L, uint64_t* pOut) {
+    if (L < 64) {
+        uint64_t w = 0;
+        for (uint64_t i = 0; i < L; ++i) {
+            unsigned char c = (unsigned char)p[i];
+            if ((c & 0xFE) != '0') return false;
+            w |= (uint64_t)(c & 1) << (L - 1 - i);
+        }
+        pOut[0] = w;
+        return true;
+    }
+    uint64_t bad = 0;
+    uint64_t nWords = L >> 6;
+    for (uint64_t w = 0; w < nWords; ++w) {
+        // word w holds minterms [64w, 64w+63] = characters [L-64(w+1), L-64w) reversed
+        pOut[w] = TruthBitReverse64(TruthPack64(p + (L - 64 * (w + 1)), bad));
+    }
+    return bad == 0;
+}
+
+// =========================================================
+// Text lines
+// =========================================================
+
+// One non-empty line of a .truth file (leading/trailing whitespace trimmed).
+struct TruthLine { const char* p; size_t n; };
+
+// Only looks for newlines, nothing is parsed.  Lines with inner whitespace
+// are copied into `compacted` without it, and their spans point there.
+inline void TruthIndexLines(const char* data, size_t size, std::vector<TruthLine>& lines,
+                            std::vector<std::string>& compacted) {
+    lines.clear();
+    compacted.clear();
+    const char* cur = data;
+    const char* end = cur + size;
+    while (cur < end) {
+        const char* nl = static_cast<const char*>(std::memchr(cur, '\n', (size_t)(end - cur)));
+        const char* eol = nl ? nl : end;
+        const char* b = cur;
+        const char* e = eol;
+        while (b < e && std::isspace((unsigned char)*b)) ++b;
+        while (e > b && std::isspace((unsigned char)e[-1])) --e;
+        if (b < e) {
+            size_t n = (size_t)(e - b);
+            bool inner = std::memchr(b, ' ', n) || std::memchr(b, '\t', n) || std::memchr(b, '\r', n);
+            if (inner) {
+                std::string s;
+                for (const char* q = b; q < e; ++q)
+                    if (!std::isspace((unsigned char)*q)) s.push_back(*q);
+                compacted.push_back(std::move(s));
+                lines.push_back({nullptr, compacted.size() - 1});
+            } else {
+                lines.push_back({b, (size_t)(e - b)});
+            }
+        }
+        cur = eol + 1;
+    }
+    for (auto& l : lines) {
+        if (!l.p) {
+            const std::string& c = compacted[l.n];
+            l.p = c.data();
+            l.n = c.size();
+        }
+    }
+}
+
+// Every line has the same power-of-2 length L.
+inline bool TruthCheckLines(const std::vector<TruthLine>& lines, const std::string& filename, uint64_t& L,
+                            std::string& err) {
+    if (lines.empty()) {
+        err = "No valid truth tables found in " + filename;
+        return false;
+    }
+    L = lines[0].n;
+    for (size_t i = 1; i < lines.size(); ++i) {
+        if (lines[i].n != L) {
+            err = "Line " + std::to_string(i) + " length mismatch: " +
+                  std::to_string(lines[i].n) + " vs " + std::to_string(L);
+            return false;
+        }
+    }
+    if (L < 2 || (L & (L - 1)) != 0) {
+        err = "Truth length " + std::to_string(L) + " is not a power of 2";
+        return false;
+    }
+    return true;
+}
+
+// =========================================================
+// Binary container (.tbin)
+//
+// A 64-byte header, one checksum per output, then every output as
+// TruthWordNum(nVars) packed words (the layout above) from a 64-byte
+// aligned offset, so a mapped file gives direct access to any single
+// output.  headerSum covers the header (with headerSum = 0) and the
+// checksum table; outSum[j] covers the words of output j.  Native byte
+// order.  Written by bin/truthconv/main.
+// =========================================================
+
+const char TRUTH_BIN_MAGIC[8] = {'A', 'I', 'G', 'M', 'T', 'T', 'B', '\0'};
+const uint32_t TRUTH_BIN_VERSION = 1;
+const uint32_t TRUTH_BIN_MAX_VARS = 36;  // TruthWordNum 的 int 可以表示的上限（2^30 words）
+
+struct TruthBinHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nVars;
+    uint32_t nOuts;
+    uint32_t reserved0;
+    uint64_t nWords;       // words per output
+    uint64_t dataOffset;   // byte offset of output 0
+    uint64_t headerSum;
+    uint64_t reserved[2];
+};
+static_assert(sizeof(TruthBinHeader) == 64, "TruthBinHeader must stay 64 bytes");
+
+inline uint64_t TruthBinChecksum(const uint64_t* p, size_t n, uint64_t h = 0x9e3779b97f4a7c15ULL) {
+    for (size_t i = 0; i < n; ++i) {
+        h = (h ^ p[i]) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+inline uint64_t TruthBinHeaderSum(TruthBinHeader hdr, const uint64_t* outSum) {
+    hdr.headerSum = 0;
+    uint64_t words[8];
+    std::memcpy(words, &hdr, sizeof(hdr));
+    return TruthBinChecksum(outSum, hdr.nOuts, TruthBinChecksum(words, 8));
+}
+
+inline bool TruthIsBinary(const char* p, size_t n) {
+    return n >= sizeof(TRUTH_BIN_MAGIC) && std::memcmp(p, TRUTH_BIN_MAGIC, sizeof(TRUTH_BIN_MAGIC)) == 0;
+}
+
+// .truth 或 .tbin（其他 driver 用副檔名判斷輸入種類時用）
+inline bool TruthIsTableFile(const std::string& filename) {
+    auto ends = [&](const char* ext) {
+        size_t n = std::strlen(ext);
+        return filename.size() >= n && filename.compare(filename.size() - n, n, ext) == 0;
+    };
+    return ends(".truth") || ends(".tbin");
+}
+
+// 驗證 header、大小與 checksum table；outSum 指向 mapped 的 table
+inline bool TruthBinCheckHeader(const char* p, size_t size, const std::string& filename, TruthBinHeader& hdr,
+                                const uint64_t*& outSum, std::string& err) {
+    if (size < sizeof(hdr)) {
+        err = "Truncated binary truth file " + filename;
+        return false;
+    }
+    std::memcpy(&hdr, p, sizeof(hdr));
+    if (hdr.version != TRUTH_BIN_VERSION || hdr.nVars < 1 || hdr.nVars > TRUTH_BIN_MAX_VARS || hdr.nOuts < 1 ||
+        hdr.nOuts > (uint32_t)INT_MAX || hdr.nWords != (uint64_t)TruthWordNum((int)hdr.nVars)) {
+        err = "Unsupported binary truth header in " + filename;
+        return false;
+    }
+    // 資料區剛好是 nOuts * nWords 個 word（用除法比對，nOuts * nWords * 8 不會溢位）
+    uint64_t tableEnd = sizeof(hdr) + 8ULL * hdr.nOuts;
+    uint64_t outBytes = 8ULL * hdr.nWords;
+    if (hdr.dataOffset != ((tableEnd + 63) & ~63ULL) || size < hdr.dataOffset ||
+        (size - hdr.dataOffset) % outBytes != 0 || (size - hdr.dataOffset) / outBytes != hdr.nOuts) {
+        err = "Size mismatch in binary truth file " + filename;
+        return false;
+    }
+    outSum = reinterpret_cast<const uint64_t*>(p + sizeof(hdr));
+    if (TruthBinHeaderSum(hdr, outSum) != hdr.headerSum) {
+        err = "Header checksum mismatch in " + filename;
+        return false;
+    }
+    return true;
+}
+
+inline bool TruthBinLoad(const MappedFile& file, const std::string& filename, TruthTable& tt, std::string& err) {
+    TruthBinHeader hdr;
+    const uint64_t* outSum = nullptr;
+    if (!TruthBinCheckHeader(file.Data(), file.Size(), filename, hdr, outSum, err)) return false;
+    tt.nVars = (int)hdr.nVars;
+    tt.nOuts = (int)hdr.nOuts;
+    tt.nBits = 1ULL << hdr.nVars;
+    tt.nWords = (int)hdr.nWords;
+    const uint64_t* data = reinterpret_cast<const uint64_t*>(file.Data() + hdr.dataOffset);
+    tt.words.assign(data, data + (size_t)tt.nOuts * tt.nWords);
+    for (int j = 0; j < tt.nOuts; ++j) {
+        if (TruthBinChecksum(tt.Output(j), tt.nWords) != outSum[j]) {
+            err = "Output " + std::to_string(j) + " checksum mismatch in " + filename;
+            return false;
+        }
+    }
+    return true;
+}
+
+// =========================================================
+// Loader
+// =========================================================
+
+// .truth text or .tbin (detected by the magic, not the extension).
+inline bool LoadTruthFile(const std::string& filename, TruthTable& tt, std::string& err) {
+    tt = TruthTable();
+    MappedFile file;
+    if (!file.Open(filename)) {
+        err = "Could not open file " + filename;
+        return false;
+    }
+    if (TruthIsBinary(file.Data(), file.Size())) return TruthBinLoad(file, filename, tt, err);
+
+    // 1. Locate the non-empty lines.
+    std::vector<TruthLine> lines;
+    std::vector<std::string> compacted; // only for lines with inner whitespace
+    TruthIndexLines(file.Data(), file.Size(), lines, compacted);
+
+    // 2. Validate the shape once.
+    uint64_t L = 0;
+    if (!TruthCheckLines(lines, filename, L, err)) return false;
+
+    tt.nVars = __builtin_ctzll(L);
+    tt.nOuts = (int)lines.size();
+    tt.nBits = L;
+    tt.nWords = TruthWordNum(tt.nVars);
+    tt.words.assign((size_t)tt.nOuts * tt.nWords, 0);
+
+    // 3. Pack.
+    for (int j = 0; j < tt.nOuts; ++j) {
+        if (!TruthParseLine(lines[j].p, L, tt.Output(j))) {
+            err = "Line " + std::to_string(j) + " contains characters other than '0'/'1'";
+            return false;
+        }
+    }
+    return true;
+}
+
+// =========================================================
+// Streaming reader (one output at a time)
+//
+// Opening maps the file and reads only the .tbin header or the positions
+// of the .truth lines; Read(j) then packs output j alone, so a driver that
+// synthesizes one output never holds the others.
+// =========================================================
+
+class TruthStream {
+public:
+    bool Open(const std::string& filename, std::string& err) {
+        filename_ = filename;
+        lines_.clear();
+        compacted_.clear();
+        if (!file_.Open(filename)) {
+            err = "Could not open file " + filename;
+            return false;
+        }
+        binary_ = TruthIsBinary(file_.Data(), file_.Size());
+        if (binary_) {
+            if (!TruthBinCheckHeader(file_.Data(), file_.Size(), filename, hdr_, outSum_, err)) return false;
+            nVars_ = (int)hdr_.nVars;
+            nOuts_ = (int)hdr_.nOuts;
+            return true;
+        }
+        TruthIndexLines(file_.Data(), file_.Size(), lines_, compacted_);
+        uint64_t L = 0;
+        if (!TruthCheckLines(lines_, filename, L, err)) return false;
+        nVars_ = __builtin_ctzll(L);
+        nOuts_ = (int)lines_.size();
+        return true;
+    }
+
+    int NumVars() const { return nVars_; }
+    int NumOuts() const { return nOuts_; }
+    int NumWords() const { return TruthWordNum(nVars_); }
+
+    // output j 的 packed words
+    bool Read(int j, std::vector<uint64_t>& words, std::string& err) const {
+        if (j < 0 || j >= nOuts_) {
+            err = "Output " + std::to_string(j) + " out of range (" + std::to_string(nOuts_) + " outputs) in " +
+                  filename_;
+            return false;
+        }
+        int nWords = NumWords();
+        if (binary_) {
+            const uint64_t* p = reinterpret_cast<const uint64_t*>(file_.Data() + hdr_.dataOffset) + (size_t)j * nWords;
+            words.assign(p, p + nWords);
+            if (TruthBinChecksum(words.data(), nWords) != outSum_[j]) {
+                err = "Output " + std::to_string(j) + " checksum mismatch in " + filename_;
+                return false;
+            }
+            return true;
+        }
+        words.assign(nWords, 0);
+        if (!TruthParseLine(lines_[j].p, 1ULL << nVars_, words.data())) {
+            err = "Line " + std::to_string(j) + " contains characters other than '0'/'1'";
+            return false;
+        }
+        return true;
+    }
+
+    // 只含 output j 的 TruthTable
+    bool ReadTable(int j, TruthTable& tt, std::string& err) const {
+        tt = TruthTable();
+        tt.nVars = nVars_;
+        tt.nOuts = 1;
+        tt.nBits = 1ULL << nVars_;
+        tt.nWords = NumWords();
+        return Read(j, tt.words, err);
+    }
+
+private:
+    std::string filename_;
+    MappedFile file_;
+    bool binary_ = false;
+    TruthBinHeader hdr_{};
+    const uint64_t* outSum_ = nullptr;
+    std::vector<TruthLine> lines_;
+    std::vector<std::string> compacted_;
+    int nVars_ = 0;
+    int nOuts_ = 0;
+};
+
+// =========================================================
+// Writers
+// =========================================================
+
+inline bool TruthWriteBuffer(const std::string& filename, const std::string& buf, std::string& err) {
+    FILE* f = std::fopen(filename.c_str(), "wb");
+    if (!f) {
+        err = "Cannot open output file " + filename;
+        return false;
+    }
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) err = "Failed to write " + filename;
+    return ok;
+}
+
+inline bool TruthWriteBinary(const std::string& filename, const TruthTable& tt, std::string& err) {
+    TruthBinHeader hdr{};
+    std::memcpy(hdr.magic, TRUTH_BIN_MAGIC, sizeof(hdr.magic));
+    hdr.version = TRUTH_BIN_VERSION;
+    hdr.nVars = (uint32_t)tt.nVars;
+    hdr.nOuts = (uint32_t)tt.nOuts;
+    hdr.nWords = (uint64_t)tt.nWords;
+    hdr.dataOffset = (sizeof(hdr) + 8ULL * tt.nOuts + 63) & ~63ULL;
+    std::vector<uint64_t> outSum(tt.nOuts);
+    for (int j = 0; j < tt.nOuts; ++j) outSum[j] = TruthBinChecksum(tt.Output(j), tt.nWords);
+    hdr.headerSum = TruthBinHeaderSum(hdr, outSum.data());
+
+    std::string buf(hdr.dataOffset, '\0');
+    std::memcpy(&buf[0], &hdr, sizeof(hdr));
+    std::memcpy(&buf[sizeof(hdr)], outSum.data(), 8 * outSum.size());
+    buf.append(reinterpret_cast<const char*>(tt.words.data()), 8 * tt.words.size());
+    return TruthWriteBuffer(filename, buf, err);
+}
+
+// .truth text, MSB-first
+inline bool TruthWriteText(const std::string& filename, const TruthTable& tt, std::string& err) {
+    std::string buf;
+    buf.reserve((size_t)tt.nOuts * (tt.nBits + 1));
+    for (int j = 0; j < tt.nOuts; ++j) {
+        for (uint64_t m = tt.nBits; m-- > 0;) buf.push_back(tt.Get(j, m) ? '1' : '0');
+        buf.push_back('\n');
+    }
+    return TruthWriteBuffer(filename, buf, err);
+}
+
+// =========================================================
+// Hex encoding (for ABC's read_truth)
+// =========================================================
+
+inline std::string TruthToHex(const uint64_t* pWords, int nVars) {
+    static const char* digits = "0123456789abcdef";
+    uint64_t nBits = 1ULL << nVars;
+    if (nBits < 4) return std::string(1, digits[pWords[0] & 0xF]);
+    uint64_t nDigits = nBits / 4;
+    std::string hex(nDigits, '0');
+    for (uint64_t k = 0; k < nDigits; ++k) {
+        unsigned nib = (unsigned)(pWords[k >> 4] >> (4 * (k & 15))) & 0xF;
+        hex[nDigits - 1 - k] = digits[nib];
+    }
+    return hex;
+}
+
+#endif
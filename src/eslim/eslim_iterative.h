@@ -0,0 +1,486 @@
+#ifndef ESLIM_ITERATIVE_H
+#define ESLIM_ITERATIVE_H
+
+// =========================================================
+// Iterative eSLIM minimization
+//
+// run_iterative_eslim repeatedly hands the current best AIG to a portfolio
+// of resident eSLIM workers (eslim_session.h), keeps the best verified
+// result, and adapts the per-round time slice to the improvement rate.
+// Large AIGs are split into one window per worker (common/aig_window.h).
+// Whole-circuit candidates are checked incrementally against the current
+// best (common/aig_incremental.h), so a round that touched a few cones
+// only pays for those cones.
+// Used by bin/eslim/main and by the orchestrator, which keeps one
+// EslimPortfolio alive across all of its eSLIM passes.
+// =========================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/aig_check.h"
+#include "common/aig_incremental.h"
+#include "common/aiger.h"
+#include "common/aig_window.h"
+#include "common/scratch.h"
+#include "eslim/eslim_session.h"
+
+// =========================================================
+// CONFIGURATION
+// =========================================================
+
+const unsigned ESLIM_DEFAULT_SEED = 1;  // seed=0（或沒給）時使用，同樣的輸入與參數會得到同樣的結果
+
+struct EslimConfig {
+    int totalTimeLimit = 300;
+    int iterTimeLimit = 60;
+    int nWorkers = 1;              // 同時跑的 eSLIM instance 數（portfolio）
+    std::vector<int> gsList = {2}; // worker w 使用 gsList[w % size]
+    unsigned seed = 0;             // 0 = ESLIM_DEFAULT_SEED
+    // 自適應時間片（見 run_iterative_eslim）
+    int minIterTime = 10;          // 時間片下限
+    int maxIterTime = 0;           // 時間片上限，0 = 4 * iterTimeLimit
+    int stallRetries = 2;          // 沒有改善時最多重試幾輪
+    int maxGsBoost = 2;            // 重試時 --gs 最多加多少
+    int windowMinAnds = 1000;      // AND 數達到此值且 workers > 1 時切 window 平行跑，0 = 關閉
+};
+
+// 填入依其他欄位而定的預設值（命令列解析之後呼叫）
+inline void EslimFinalizeConfig(EslimConfig& config) {
+    if (config.seed == 0) config.seed = ESLIM_DEFAULT_SEED;
+    if (config.maxIterTime <= 0) config.maxIterTime = 4 * config.iterTimeLimit;
+    config.minIterTime = std::max(1, std::min(config.minIterTime, config.iterTimeLimit));
+    config.maxIterTime = std::max(config.maxIterTime, config.iterTimeLimit);
+}
+
+// =========================================================
+// Single runs
+// =========================================================
+
+inline bool start_eslim_session(EslimSession& session) {
+    // 1. Paths relative to project root
+    // We use the Python interpreter inside the .venv created by 'make eslim'
+    std::string pythonExe = ".venv/bin/python3";
+    std::string scriptPath = "third_party/eslim/src/reduce.py";
+    std::string workerPath = "scripts/eslim_worker.py";
+    // We need to add the source dir to PYTHONPATH so it finds the 'bindings' module
+    std::string bindingsPath = "third_party/eslim/src"; 
+    
+    // 2. Sanity Check: Does venv exist?
+    std::ifstream f(pythonExe.c_str());
+    if (!f.good()) {
+        std::cerr << "[C++] Error: Python venv not found at " << pythonExe << std::endl;
+        std::cerr << "[C++] Please run 'make eslim' to setup the environment." << std::endl;
+        return false;
+    }
+
+    // 3. 啟動常駐的 worker（interpreter 與 bindings 只載入一次，見 eslim_session.h）
+    std::string err;
+    if (!session.Start(pythonExe, workerPath, scriptPath, bindingsPath, err)) {
+        std::cerr << "[C++] Error: " << err << std::endl;
+        return false;
+    }
+    std::cout << "[C++] eSLIM worker started." << std::endl;
+    return true;
+}
+
+// 可能在 worker thread 中執行，所以不印 log，由呼叫端在 join 之後輸出
+inline int run_eslim_optimization(EslimSession& session, std::string inputFile, std::string outputFile, int timeLimit,
+                                  unsigned seed, int gs, EslimResult& result, std::string& err) {
+    // reduce.py 的參數與原本的命令列相同，另外指定 --gs 與 --seed
+    std::vector<std::string> args = {inputFile, outputFile, std::to_string(timeLimit),
+                                     "--aig", "--aig-out", outputFile, "--gs", std::to_string(gs), "--syn-mode", "sat",
+                                     "--seed", std::to_string(seed)};
+    return session.Run(args, outputFile, result, err) ? 0 : 1;
+}
+
+// 候選結果必須與本輪起點等價：輸入不多時 exhaustive 模擬（common/aig_check.h），
+// 否則（例如輸入很多的 window）退回 4096 個隨機 pattern
+inline bool verify_candidate(const AigGraph& ref, const std::string& candFile, std::string& err) {
+    AigGraph cand;
+    if (!AigerRead(candFile, cand, err)) return false;
+    if (ref.nPis <= AIG_CHECK_MAX_VARS) {
+        AigCheckResult res;
+        if (!AigCheckAigs(ref, cand, res, err)) return false;
+        if (!res.equivalent) err = res.reason;
+        return res.equivalent;
+    }
+    if (cand.nPis != ref.nPis || cand.outputs.size() != ref.outputs.size() || cand.nLatches || ref.nLatches) {
+        err = "interface mismatch";
+        return false;
+    }
+    const int nWords = 64;
+    std::mt19937_64 rng(12345);
+    std::vector<uint64_t> pi((size_t)ref.nPis * nWords);
+    for (uint64_t& w : pi) w = rng();
+
+    auto simulate = [&](const AigGraph& g, std::vector<uint64_t>& outs) {
+        std::vector<uint64_t> val((size_t)(g.MaxVar() + 1) * nWords, 0);
+        for (int i = 0; i < g.nPis; ++i)
+            std::copy(pi.begin() + (size_t)i * nWords, pi.begin() + (size_t)(i + 1) * nWords,
+                      val.begin() + (size_t)(i + 1) * nWords);
+        auto lit = [&](unsigned l, int w) {
+            uint64_t x = val[(size_t)(l >> 1) * nWords + w];
+            return (l & 1) ? ~x : x;
+        };
+        for (int k = 0; k < g.AndNum(); ++k) {
+            size_t base = (size_t)(g.AndLit(k) >> 1) * nWords;
+            for (int w = 0; w < nWords; ++w) val[base + w] = lit(g.fanin0[k], w) & lit(g.fanin1[k], w);
+        }
+        outs.clear();
+        for (unsigned o : g.outputs)
+            for (int w = 0; w < nWords; ++w) outs.push_back(lit(o, w));
+    };
+    std::vector<uint64_t> outRef, outCand;
+    simulate(ref, outRef);
+    simulate(cand, outCand);
+    if (outRef != outCand) {
+        err = "simulation mismatch";
+        return false;
+    }
+    return true;
+}
+
+// 整個電路的候選與 verifier 的參考（目前的 best）增量比對。support 超過 AIG_CHECK_MAX_VARS 的 cone
+// 只經過 signature 過濾（1024 個隨機 pattern），沒有 SAT 可用；orchestrator 會再對整個 pass 的結果做 cec
+inline bool verify_candidate_incremental(AigIncrementalVerifier& verifier, const AigGraph& cand, std::string& err) {
+    auto signatureOnly = [](const AigGraph&, const AigGraph&, AigCheckResult& res, std::string&) {
+        res.equivalent = true;
+        res.method = "signature";
+        return true;
+    };
+    AigCheckResult res;
+    if (!verifier.Check(cand, res, err, signatureOnly)) return false;
+    if (!res.equivalent) err = res.reason;
+    return res.equivalent;
+}
+
+inline void copy_file(std::string srcFilename, std::string dstFilename) {
+    std::ifstream src(srcFilename, std::ios::binary);
+    std::ofstream dst(dstFilename, std::ios::binary);
+    if (src && dst) {
+        dst << src.rdbuf();
+        std::cout << "[Fallback] Copied " << srcFilename << " to " << dstFilename << std::endl;
+    } else {
+        std::cerr << "[Fallback] Error: Could not copy file." << std::endl;
+    }
+}
+
+inline int get_gate_count(std::string filename) {
+    // 只讀 AIGER header 的 A 欄位（見 common/aiger.h）
+    AigerHeader hdr;
+    std::string err;
+    if (!AigerReadHeader(filename, hdr, err)) return -1;
+    return (int)hdr.A;
+}
+
+// =========================================================
+// Worker portfolio
+// =========================================================
+
+// 常駐的 eSLIM worker，各自用不同的 seed / --gs
+struct EslimWorker {
+    EslimSession session;
+    int gs = 2;
+    std::string candFile;
+    EslimResult result;
+    int res = 1;
+    std::string err;
+};
+
+struct EslimPortfolio {
+    std::vector<std::unique_ptr<EslimWorker>> workers;
+
+    bool Started() const { return !workers.empty(); }
+
+    bool Start(const EslimConfig& config, const ScratchDir& scratch) {
+        workers.clear();
+        for (int w = 0; w < config.nWorkers; ++w) {
+            std::unique_ptr<EslimWorker> worker(new EslimWorker());
+            if (!start_eslim_session(worker->session)) break;
+            worker->gs = config.gsList[w % config.gsList.size()];
+            worker->candFile = scratch.File("cand" + std::to_string(w) + ".aig");
+            workers.push_back(std::move(worker));
+        }
+        if (workers.empty()) return false;
+        if ((int)workers.size() < config.nWorkers)
+            std::cerr << "[Iterative] Only " << workers.size() << " of " << config.nWorkers << " workers started." << std::endl;
+        return true;
+    }
+};
+
+// =========================================================
+// Iterative loop
+// =========================================================
+
+// pPortfolio 為 nullptr 時自己啟動 worker，結束時關掉；否則沿用呼叫端的（可跨多次呼叫）
+inline int run_iterative_eslim(std::string inputFile, std::string outputFile, const EslimConfig& config,
+                               const ScratchDir& scratch, EslimPortfolio* pPortfolio = nullptr) {
+    int totalTimeLimit = config.totalTimeLimit;
+    int iterTimeLimit = config.iterTimeLimit;
+    std::cout << "[Iterative] Starting loop. Total Budget: " << totalTimeLimit 
+              << "s, Step Budget: " << iterTimeLimit << "s (adaptive " << config.minIterTime << "-"
+              << config.maxIterTime << "s)" << std::endl;
+    
+    auto startTime = std::chrono::steady_clock::now();
+    auto secondsSince = [](std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+    };
+    
+    // Initialize: Copy input to output as the "Best So Far"
+    copy_file(inputFile, outputFile);
+    
+    int bestCost = get_gate_count(outputFile);
+    if (bestCost == -1) {
+        std::cerr << "[Iterative] Error: Could not read input AIG size." << std::endl;
+        return 1;
+    }
+    int initialCost = bestCost;
+    std::cout << "[Iterative] Initial Size: " << bestCost << " AND gates." << std::endl;
+
+    EslimPortfolio localPortfolio;
+    EslimPortfolio& portfolio = pPortfolio ? *pPortfolio : localPortfolio;
+    if (!portfolio.Started() && !portfolio.Start(config, scratch)) return 1;
+    std::vector<std::unique_ptr<EslimWorker>>& workers = portfolio.workers;
+
+    // 目前最好的結果留在工作區，每輪所有 worker 都從它開始；改善時只 rename，不再反覆複製
+    std::string bestFile = scratch.File("best.aig");
+    copy_file(inputFile, bestFile);
+    AigGraph bestAig;
+    std::string err;
+    if (!AigerRead(bestFile, bestAig, err)) {
+        std::cerr << "[Iterative] Error: " << err << std::endl;
+        return 1;
+    }
+    AigIncrementalVerifier verifier;
+    verifier.Reset(bestAig);
+
+    // 時間片調整：以每輪「每秒減少的 AND 數」為依據
+    //   - 改善速率不低於上一輪 => 還在穩定下降，時間片 x1.5（少付 restart 成本）
+    //   - 改善速率掉到上一輪一半以下 => 報酬遞減，時間片 x0.75
+    //   - 沒有改善 => 換 seed 重試；第二次起再把 --gs 加 1（更大的 window），
+    //     連續 stallRetries 次都沒有改善才停止
+    double slice = iterTimeLimit;
+    double lastRate = -1;
+    int stalls = 0;
+    int gsBoost = 0;
+
+    // 預算使用紀錄（最後輸出報告）
+    double setupSecs = secondsSince(startTime);
+    double improvingSecs = 0, stalledSecs = 0, failedSecs = 0;
+    int nImproving = 0, nStalled = 0, nFailed = 0;
+    std::string stopReason = "time limit";
+
+    int iteration = 1;
+    int round = 0;
+
+    while (true) {
+        // Check remaining time
+        int elapsed = (int)secondsSince(startTime);
+        int remaining = totalTimeLimit - elapsed;
+
+        if (remaining <= 5) { // 5s buffer for safety
+            std::cout << "[Iterative] Total time limit reached." << std::endl;
+            break;
+        }
+
+        // Determine budget for this specific run
+        // If remaining time is less than the current slice, use whatever is left
+        int currentLimit = std::min(remaining, std::max(1, (int)std::lround(slice)));
+
+        // 大電路且有多個 worker 時，把 AIG 切成每個 worker 一個 window 同時最佳化；
+        // 沒有改善的重試輪改跑整個電路，讓 window 邊界上的結構也有機會被處理
+        std::vector<AigWindow> windows;
+        std::vector<std::string> inputs(workers.size(), bestFile);
+        bool windowed = workers.size() > 1 && config.windowMinAnds > 0 &&
+                        bestAig.AndNum() >= std::max(config.windowMinAnds, (int)workers.size()) && stalls % 2 == 0;
+        if (windowed) {
+            // 奇數輪把切點移半個 window，邊界不會每輪都一樣
+            int shift = (round % 2) ? bestAig.AndNum() / (int)workers.size() / 2 : 0;
+            std::string werr;
+            windowed = AigPartition(bestAig, (int)workers.size(), shift, windows, werr) &&
+                       windows.size() == workers.size();
+            for (size_t w = 0; windowed && w < windows.size(); ++w) {
+                inputs[w] = scratch.File("win" + std::to_string(w) + ".aig");
+                windowed = AigerWrite(inputs[w], windows[w].graph, werr);
+            }
+            if (!windowed) {
+                std::cerr << "[Iterative] Windowing skipped (" << werr << ")." << std::endl;
+                inputs.assign(workers.size(), bestFile);
+            }
+        }
+
+        std::cout << "[Iterative] Iteration " << iteration << " (Limit: " << currentLimit << "s, "
+                  << workers.size() << (windowed ? " window(s)" : " worker(s)");
+        if (stalls) std::cout << ", retry " << stalls << "/" << config.stallRetries;
+        if (gsBoost) std::cout << ", gs +" << gsBoost;
+        std::cout << ")..." << std::endl;
+
+        // 所有 worker 同時跑同一個時間片，wall-clock 預算由各核心分攤
+        auto roundStart = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workers.size(); ++w) {
+            EslimWorker* worker = workers[w].get();
+            const std::string* input = &inputs[w];
+            unsigned seed = config.seed + (unsigned)(round * workers.size() + w);
+            int gs = worker->gs + gsBoost;
+            threads.emplace_back([worker, input, currentLimit, seed, gs]() {
+                worker->err.clear();
+                worker->res = run_eslim_optimization(worker->session, *input, worker->candFile, currentLimit,
+                                                     seed, gs, worker->result, worker->err);
+            });
+        }
+        for (auto& t : threads) t.join();
+        ++round;
+
+        std::string roundFile;  // 這一輪的結果（相對於 best.aig 已驗證）
+        const AigGraph* roundAig = nullptr;
+        std::vector<AigGraph> cands(workers.size());
+        AigGraph stitched;
+        int newCost = -1;
+        if (windowed) {
+            // 每個 window 只在變小時替換，接回去後 strash 並對整個電路再驗證一次
+            std::vector<AigGraph> improved(windows.size());
+            std::vector<const AigGraph*> replacement(windows.size(), nullptr);
+            bool anyOk = false;
+            for (size_t w = 0; w < windows.size(); ++w) {
+                EslimWorker& worker = *workers[w];
+                if (worker.res != 0) {
+                    std::cerr << "[Iterative] Window " << w << " failed (" << worker.err << ")." << std::endl;
+                    continue;
+                }
+                std::string verr;
+                if (!verify_candidate(windows[w].graph, worker.candFile, verr)) {
+                    std::cerr << "[Iterative] Window " << w << " result rejected (" << verr << ")." << std::endl;
+                    continue;
+                }
+                anyOk = true;
+                std::cout << "[Iterative] Window " << w << " (" << windows[w].graph.nPis << " in, "
+                          << windows[w].outputs.size() << " out): " << windows[w].graph.AndNum() << " -> "
+                          << worker.result.gates << " AND gates, " << worker.result.seconds << "s" << std::endl;
+                if (worker.result.gates < windows[w].graph.AndNum() && AigerRead(worker.candFile, improved[w], verr))
+                    replacement[w] = &improved[w];
+            }
+            std::string serr;
+            if (anyOk) {
+                roundFile = scratch.File("stitched.aig");
+                if (AigStitch(bestAig, windows, replacement, stitched, serr) && AigerWrite(roundFile, stitched, serr) &&
+                    verify_candidate_incremental(verifier, stitched, serr)) {
+                    newCost = stitched.AndNum();
+                    roundAig = &stitched;
+                } else {
+                    // 接回去的結果不可信就當作這輪沒有改善
+                    std::cerr << "[Iterative] Stitched result rejected (" << serr << ")." << std::endl;
+                    roundFile = bestFile;
+                    newCost = bestCost;
+                    roundAig = &bestAig;
+                }
+            }
+        } else {
+            // 取驗證通過的最佳結果（AND 數優先，再比 depth）
+            int bestWorker = -1;
+            for (size_t w = 0; w < workers.size(); ++w) {
+                EslimWorker& worker = *workers[w];
+                if (worker.res != 0) {
+                    std::cerr << "[Iterative] Worker " << w << " failed (" << worker.err << ")." << std::endl;
+                    continue;
+                }
+                std::string verr;
+                if (!AigerRead(worker.candFile, cands[w], verr) || !verify_candidate_incremental(verifier, cands[w], verr)) {
+                    std::cerr << "[Iterative] Worker " << w << " result rejected (" << verr << ")." << std::endl;
+                    continue;
+                }
+                std::cout << "[Iterative] Worker " << w << " (gs " << worker.gs + gsBoost << "): " << worker.result.gates
+                          << " AND gates, depth " << worker.result.depth << ", " << worker.result.seconds << "s" << std::endl;
+                if (bestWorker < 0 || worker.result.gates < workers[bestWorker]->result.gates ||
+                    (worker.result.gates == workers[bestWorker]->result.gates &&
+                     worker.result.depth < workers[bestWorker]->result.depth))
+                    bestWorker = (int)w;
+            }
+            if (bestWorker >= 0) {
+                roundFile = workers[bestWorker]->candFile;
+                roundAig = &cands[bestWorker];
+                newCost = roundAig->AndNum();
+            }
+        }
+        double roundSecs = secondsSince(roundStart);
+        
+        if (newCost < 0) {
+            failedSecs += roundSecs;
+            nFailed++;
+            stopReason = "eSLIM failure";
+            std::cerr << "[Iterative] eSLIM run failed or timed out hard. Stopping." << std::endl;
+            break;
+        }
+
+        std::cout << "[Iterative] Size change: " << bestCost << " -> " << newCost << std::endl;
+
+        if (newCost < bestCost) {
+            double rate = (bestCost - newCost) / std::max(roundSecs, 1e-3);
+            std::cout << "[Iterative] Improvement found! Updating best result (" << std::fixed << std::setprecision(2)
+                      << rate << " gates/s)." << std::defaultfloat << std::endl;
+            bestCost = newCost;
+            std::rename(roundFile.c_str(), bestFile.c_str());
+            // 最後一次 Check 的若不是這個結果（多個 worker），Commit 失敗就整個重建
+            if (!verifier.Commit(*roundAig)) verifier.Reset(*roundAig);
+            bestAig = *roundAig;
+            copy_file(bestFile, outputFile);
+            iteration++;
+
+            improvingSecs += roundSecs;
+            nImproving++;
+            // 只有用滿時間片的一輪才能說明時間片太短/太長；提早結束的不調整
+            bool usedSlice = roundSecs >= 0.8 * currentLimit;
+            if (usedSlice && (lastRate < 0 || rate >= lastRate)) slice = std::min<double>(slice * 1.5, config.maxIterTime);
+            else if (lastRate > 0 && rate < 0.5 * lastRate) slice = std::max<double>(slice * 0.75, config.minIterTime);
+            lastRate = rate;
+            stalls = 0;
+            gsBoost = 0;
+        } else {
+            stalledSecs += roundSecs;
+            nStalled++;
+            if (stalls >= config.stallRetries) {
+                stopReason = "converged";
+                std::cout << "[Iterative] No improvement (Converged). Stopping." << std::endl;
+                break;
+            }
+            stalls++;
+            // 第一次只換 seed（round 已前進），之後再放大 window
+            if (stalls >= 2 && gsBoost < config.maxGsBoost) gsBoost++;
+            std::cout << "[Iterative] No improvement. Retrying with a fresh seed"
+                      << (gsBoost ? " and gs +" + std::to_string(gsBoost) : std::string()) << "." << std::endl;
+        }
+    }
+
+    std::cout << "[Iterative] Final Result: " << bestCost << " AND gates." << std::endl;
+
+    // 預算報告
+    double totalSecs = secondsSince(startTime);
+    double spent = setupSecs + improvingSecs + stalledSecs + failedSecs;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[Budget] " << round << " round(s), stopped by " << stopReason << ", " << initialCost << " -> "
+              << bestCost << " AND gates (" << (initialCost - bestCost) / std::max(totalSecs, 1e-3) << " gates/s)"
+              << std::endl;
+    std::cout << "[Budget]   start-up     " << std::setw(8) << setupSecs << "s" << std::endl;
+    std::cout << "[Budget]   improving    " << std::setw(8) << improvingSecs << "s  (" << nImproving << " rounds)" << std::endl;
+    std::cout << "[Budget]   stalled      " << std::setw(8) << stalledSecs << "s  (" << nStalled << " rounds)" << std::endl;
+    if (nFailed)
+        std::cout << "[Budget]   failed       " << std::setw(8) << failedSecs << "s  (" << nFailed << " rounds)" << std::endl;
+    std::cout << "[Budget]   bookkeeping  " << std::setw(8) << std::max(0.0, totalSecs - spent) << "s" << std::endl;
+    std::cout << "[Budget]   unused       " << std::setw(8) << std::max(0.0, totalTimeLimit - totalSecs) << "s of "
+              << totalTimeLimit << "s" << std::endl;
+    std::cout << std::defaultfloat;
+    return 0;
+}
+
+#endif
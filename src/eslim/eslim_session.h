@@ -0,0 +1,176 @@
+#ifndef ESLIM_SESSION_H
+#define ESLIM_SESSION_H
+
+// =========================================================
+// Persistent eSLIM worker
+//
+// One Python child process (scripts/eslim_worker.py) is started per driver
+// run and kept alive across iterations, so the interpreter start-up and the
+// import of reduce.py / the pybind11 bindings are paid once instead of once
+// per iteration.  Requests and replies go over two dedicated pipes mapped
+// to fd 3 / fd 4 in the child; the child's stdout / stderr stay attached to
+// ours so eSLIM's log looks the same as before.
+//
+// Run() returns the AND count and depth of the result, read from the
+// output AIG with common/aiger.h, so the caller does not re-open the file.
+// =========================================================
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common/aiger.h"
+
+struct EslimResult {
+    int gates = -1;
+    int depth = -1;
+    double seconds = 0;  // worker 端量到的時間
+};
+
+class EslimSession {
+public:
+    EslimSession() = default;
+    EslimSession(const EslimSession&) = delete;
+    EslimSession& operator=(const EslimSession&) = delete;
+    ~EslimSession() { Stop(); }
+
+    bool Alive() const { return pid_ > 0; }
+
+    bool Start(const std::string& pythonExe, const std::string& workerScript, const std::string& reduceScript,
+               const std::string& bindingsPath, std::string& err) {
+        Stop();
+        int req[2], rep[2];
+        if (::pipe2(req, O_CLOEXEC) != 0) { err = "pipe() failed"; return false; }
+        if (::pipe2(rep, O_CLOEXEC) != 0) { ::close(req[0]); ::close(req[1]); err = "pipe() failed"; return false; }
+
+        // worker 掛掉時 write 不應該把整個 driver 帶走
+        std::signal(SIGPIPE, SIG_IGN);
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(req[0]); ::close(req[1]); ::close(rep[0]); ::close(rep[1]);
+            err = "fork() failed";
+            return false;
+        }
+        if (pid == 0) {
+            // 先搬到高位 fd 再 dup2 到 3 / 4，避免互相覆蓋（dup2 出來的 fd 沒有 CLOEXEC）
+            int r = ::fcntl(req[0], F_DUPFD, 10);
+            int w = ::fcntl(rep[1], F_DUPFD, 10);
+            if (r < 0 || w < 0 || ::dup2(r, 3) < 0 || ::dup2(w, 4) < 0) _exit(127);
+            const char* old = std::getenv("PYTHONPATH");
+            std::string pyPath = bindingsPath + (old && *old ? ":" + std::string(old) : "");
+            ::setenv("PYTHONPATH", pyPath.c_str(), 1);
+            std::vector<char*> argv = {const_cast<char*>(pythonExe.c_str()), const_cast<char*>(workerScript.c_str()),
+                                       const_cast<char*>(reduceScript.c_str()), const_cast<char*>("3"),
+                                       const_cast<char*>("4"), nullptr};
+            ::execv(pythonExe.c_str(), argv.data());
+            _exit(127);
+        }
+
+        ::close(req[0]);
+        ::close(rep[1]);
+        pid_ = pid;
+        toChild_ = req[1];
+        fromChild_ = rep[0];
+        buf_.clear();
+
+        std::string line;
+        if (!ReadLine(line) || line != "READY") {
+            err = "eSLIM worker failed to start" + (line.empty() ? std::string() : ": " + line);
+            Stop();
+            return false;
+        }
+        return true;
+    }
+
+    // 一次 reduce.py 呼叫；args 是 reduce.py 的命令列參數（不含 script 本身）
+    bool Run(const std::vector<std::string>& args, const std::string& outputFile, EslimResult& res, std::string& err) {
+        res = EslimResult();
+        if (!Alive()) { err = "eSLIM worker is not running"; return false; }
+
+        std::string req;
+        for (size_t i = 0; i < args.size(); ++i) {
+            if (i) req += '\t';
+            req += args[i];
+        }
+        req += '\n';
+        if (!WriteAll(req)) {
+            err = "eSLIM worker exited";
+            Stop();
+            return false;
+        }
+
+        std::string line;
+        if (!ReadLine(line)) {
+            err = "eSLIM worker exited";
+            Stop();
+            return false;
+        }
+        size_t tab = line.rfind('\t');
+        std::string status = line.substr(0, tab);
+        if (tab != std::string::npos) res.seconds = std::atof(line.c_str() + tab + 1);
+        if (status != "OK") {
+            err = status;
+            return false;
+        }
+
+        AigGraph aig;
+        if (!AigerRead(outputFile, aig, err)) return false;
+        res.gates = aig.AndNum();
+        res.depth = AigLevelNum(aig);
+        return true;
+    }
+
+    void Stop() {
+        if (pid_ <= 0) return;
+        WriteAll("QUIT\n");
+        ::close(toChild_);
+        ::close(fromChild_);
+        int status;
+        while (::waitpid(pid_, &status, 0) < 0 && errno == EINTR) {}
+        pid_ = -1;
+        toChild_ = fromChild_ = -1;
+    }
+
+private:
+    pid_t pid_ = -1;
+    int toChild_ = -1;
+    int fromChild_ = -1;
+    std::string buf_;  // 尚未取走的回覆
+
+    bool WriteAll(const std::string& s) {
+        size_t done = 0;
+        while (done < s.size()) {
+            ssize_t n = ::write(toChild_, s.data() + done, s.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            done += (size_t)n;
+        }
+        return true;
+    }
+
+    bool ReadLine(std::string& line) {
+        line.clear();
+        while (true) {
+            size_t nl = buf_.find('\n');
+            if (nl != std::string::npos) {
+                line = buf_.substr(0, nl);
+                buf_.erase(0, nl + 1);
+                return true;
+            }
+            char tmp[4096];
+            ssize_t n = ::read(fromChild_, tmp, sizeof(tmp));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            buf_.append(tmp, (size_t)n);
+        }
+    }
+};
+
+#endif
@@ -5,28 +5,13 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
 
 // ABC Headers
 #include "base/abc/abc.h"
 #include "base/main/main.h"
 
-// Helper: Convert Binary string to Hex string
-std::string BinToHex(const std::string& bin) {
-    std::string hex = "";
-    int len = bin.length();
-    // Pad to multiple of 4
-    int pad = (4 - (len % 4)) % 4;
-    std::string paddedBin = std::string(pad, '0') + bin;
-    
-    for (size_t i = 0; i < paddedBin.length(); i += 4) {
-        std::string chunk = paddedBin.substr(i, 4);
-        int val = std::stoi(chunk, nullptr, 2);
-        std::stringstream ss;
-        ss << std::hex << val;
-        hex += ss.str();
-    }
-    return hex;
-}
+#include "common/truth_table.h"
 
 int main(int argc, char * argv[]) {
     // 1. Initialize ABC
@@ -37,7 +22,7 @@ int main(int argc, char * argv[]) {
 
     // 2. Check arguments (Modified to require 3 arguments)
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <truth_file> <output_base_name>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <truth_file> <output_base_name> [output=<j>]" << std::endl;
         std::cerr << "Example: " << argv[0] << " input.truth my_results/circuit" << std::endl;
         Abc_Stop();
         return 1;
@@ -45,30 +30,40 @@ int main(int argc, char * argv[]) {
 
     std::string filename = argv[1];
     std::string outputBase = argv[2]; // Store the output argument
-    std::ifstream infile(filename);
-    
-    if (!infile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
+    int only = -1; // output=<j>: synthesize output j only
+    if (argc > 3 && std::string(argv[3]).find("output=") == 0) only = std::atoi(argv[3] + 7);
+
+    // Outputs are read one at a time (.truth: line index only, .tbin: direct
+    // offset), so the other outputs are never loaded
+    TruthStream stream;
+    std::string err;
+    if (!stream.Open(filename, err)) {
+        std::cerr << "Error: " << err << std::endl;
+        Abc_Stop();
+        return 1;
+    }
+    if (only >= stream.NumOuts()) {
+        std::cerr << "Error: output " << only << " out of range (" << stream.NumOuts() << " outputs)" << std::endl;
         Abc_Stop();
         return 1;
     }
 
     // (Removed automatic stem extraction logic as output name is now manual)
 
-    std::string line;
-    int index = 0;
+    int first = only >= 0 ? only : 0;
+    int last = only >= 0 ? only + 1 : stream.NumOuts();
+    int nWritten = 0;
+    std::vector<uint64_t> words;
 
-    // 3. Process each line
-    while (std::getline(infile, line)) {
-        // Clean line (remove whitespace)
-        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
-        
-        // Skip empty lines
-        if (line.empty()) continue;
-
-        std::cout << "Processing function #" << index << "..." << std::endl;
+    // 3. Process each function
+    for (int j = first; j < last; ++j) {
+        std::cout << "Processing function #" << j << "..." << std::endl;
+        if (!stream.Read(j, words, err)) {
+            std::cerr << "Error: " << err << std::endl;
+            continue;
+        }
 
-        std::string hexString = BinToHex(line);
+        std::string hexString = TruthToHex(words.data(), stream.NumVars());
 
         // --- COMMAND SEQUENCE START ---
 
@@ -95,7 +90,7 @@ int main(int argc, char * argv[]) {
 
         // Command 4: write_aiger
         // Construct filename using the User Provided Argument + Index + Extension
-        std::string outputFilename = outputBase + "_" + std::to_string(index) + ".aig";
+        std::string outputFilename = outputBase + "_" + std::to_string(j) + ".aig";
         
         std::string cmdWrite = "write_aiger " + outputFilename;
         if (Cmd_CommandExecute(pAbc, cmdWrite.c_str())) {
@@ -104,12 +99,10 @@ int main(int argc, char * argv[]) {
         }
 
         std::cout << "Successfully wrote to " << outputFilename << std::endl;
-        index++;
+        nWritten++;
     }
-    
-    infile.close();
 
-    if (index == 0) {
+    if (nWritten == 0) {
         std::cerr << "Warning: No valid truth tables found in file." << std::endl;
     }
 
@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/exact_db.h"
+#include "common/parallel.h"
+
+// =========================================================
+// Exact-synthesis database builder (common/exact_db.h)
+//
+// Usage: main [db=<path>] [gates=<int>] [workers=<int>] [force=1]
+//
+// Every AND chain over 4 inputs with at most `gates` ANDs is enumerated
+// once, and each NPN class keeps the shortest chain whose last AND is the
+// only unused node (so the chain is exactly that node's cone).  This is
+// exhaustive, so every class found is optimal.  Symmetry breaking:
+//   - the first AND is AND(x1, x0): any chain can be renamed/complemented
+//     to start that way, and classes are NPN-closed
+//   - two adjacent ANDs that do not depend on each other appear in
+//     increasing (fanin, fanin, polarity) order
+//   - an AND never repeats an existing function or its complement
+// Classes left over (they need more ANDs) get the smallest Shannon
+// expansion over their cofactors and are not marked exact.
+//
+// The database is rebuilt only when the file is missing, invalid, or
+// enumerated fewer gates than asked for (or with force=1).
+// =========================================================
+
+namespace {
+
+struct ChainGate {
+    int k, j, pol;  // fanin node index（0..3 = x0..x3，4.. = AND），pol bit 0 / 1 = k / j 反相
+};
+
+struct ClassBest {
+    int cost = -1;
+    uint16_t root = 0;
+    std::vector<ChainGate> gates;
+};
+
+class ChainEnumerator {
+public:
+    ChainEnumerator(const std::vector<uint32_t>& func, int nClasses, int maxGates)
+        : func_(func), maxGates_(maxGates), best_(nClasses) {
+        for (int i = 0; i < 4; ++i) tt_[i] = (uint16_t)s_TruthVar6[i];
+    }
+
+    // 第一個 AND 固定為 AND(x1, x0)，second 是第二個 AND 的 key（-1 = 只有一個 AND）
+    void Run(int second) {
+        Push(4, 1, 0, 0);
+        unused_ = 1;
+        if (second < 0) {
+            Record(5);
+        } else if (maxGates_ >= 2) {
+            int k = second >> 8, j = (second >> 2) & 63, pol = second & 3;
+            int u = Unused(k, j);
+            if (Try(5, k, j, pol)) {
+                Push(5, k, j, pol);
+                Dfs(6, u);
+            }
+        }
+    }
+
+    // 第二個 AND 所有可能的 key
+    static std::vector<int> SecondKeys() {
+        std::vector<int> keys;
+        for (int k = 1; k < 5; ++k)
+            for (int j = 0; j < k; ++j)
+                for (int p = 0; p < 4; ++p) keys.push_back(k << 8 | j << 2 | p);
+        return keys;
+    }
+
+    std::vector<ClassBest>& Best() { return best_; }
+    uint64_t Visited() const { return nVisited_; }
+
+private:
+    static int Key(int k, int j, int pol) { return k << 8 | j << 2 | pol; }
+
+    // 新增 (k, j) 之後沒有 fanout 的 AND 數
+    int Unused(int k, int j) const {
+        return unused_ + 1 - (k >= 4 && fanout_[k] == 0) - (j >= 4 && fanout_[j] == 0);
+    }
+
+    bool Try(int n, int k, int j, int pol) {
+        if (n > 4 && k != n - 1 && j != n - 1 && Key(k, j, pol) <= key_[n - 1]) return false;
+        uint16_t a = tt_[k] ^ ((pol & 1) ? 0xFFFF : 0), b = tt_[j] ^ ((pol & 2) ? 0xFFFF : 0);
+        uint16_t g = a & b;
+        if (g == 0 || g == 0xFFFF) return false;
+        for (int i = 0; i < n; ++i)
+            if (tt_[i] == g || tt_[i] == (uint16_t)~g) return false;
+        next_ = g;
+        return true;
+    }
+
+    void Push(int n, int k, int j, int pol) {
+        if (n == 4) next_ = tt_[k] & tt_[j];
+        tt_[n] = next_;
+        key_[n] = Key(k, j, pol);
+        gates_[n - 4] = {k, j, pol};
+        ++fanout_[k];
+        ++fanout_[j];
+        fanout_[n] = 0;
+    }
+
+    void Pop(int n) {
+        --fanout_[gates_[n - 4].k];
+        --fanout_[gates_[n - 4].j];
+    }
+
+    void Record(int n) {
+        ++nVisited_;
+        if (unused_ != 1) return;
+        ClassBest& b = best_[ExactDbClassOf(func_[tt_[n - 1]])];
+        int d = n - 4;
+        if (b.cost >= 0 && b.cost <= d) return;
+        b.cost = d;
+        b.root = tt_[n - 1];
+        b.gates.assign(gates_, gates_ + d);
+    }
+
+    void Dfs(int n, int u) {
+        unused_ = u;
+        Record(n);
+        int d = n - 4;
+        if (d == maxGates_) return;
+        int r = maxGates_ - d;  // 包含這一個還能加的 AND 數
+        for (int k = 1; k < n; ++k)
+            for (int j = 0; j < k; ++j) {
+                int nu = Unused(k, j);
+                if (nu > r) continue;  // 剩下的 AND 消化不完沒有 fanout 的節點
+                for (int pol = 0; pol < 4; ++pol) {
+                    if (!Try(n, k, j, pol)) continue;
+                    int saved = unused_;
+                    Push(n, k, j, pol);
+                    Dfs(n + 1, nu);
+                    Pop(n);
+                    unused_ = saved;
+                }
+            }
+    }
+
+    const std::vector<uint32_t>& func_;
+    int maxGates_;
+    std::vector<ClassBest> best_;
+    uint16_t tt_[4 + EXACT_DB_MAX_ANDS];
+    int key_[4 + EXACT_DB_MAX_ANDS];
+    int fanout_[4 + EXACT_DB_MAX_ANDS] = {0};
+    ChainGate gates_[EXACT_DB_MAX_ANDS];
+    uint16_t next_ = 0;
+    int unused_ = 0;
+    uint64_t nVisited_ = 0;
+};
+
+// =========================================================
+// Leftover classes
+// =========================================================
+
+uint16_t Cofactor(uint16_t f, int v, int phase) {
+    uint64_t m = phase ? s_TruthVar6[v] : ~s_TruthVar6[v];
+    uint64_t t = f & m;
+    t |= phase ? t >> (1 << v) : t << (1 << v);
+    return (uint16_t)t;
+}
+
+// best[c] 的 chain 接上 leaves（c 必須已經有結構）
+unsigned Instantiate(const std::vector<uint32_t>& func, const std::vector<ClassBest>& best, uint16_t f,
+                     const unsigned leaves[4], AigStrash& strash) {
+    uint32_t e = func[f];
+    const ClassBest& b = best[ExactDbClassOf(e)];
+    unsigned lit[4 + EXACT_DB_MAX_ANDS];
+    for (int p = 0; p < 4; ++p) lit[p] = leaves[ExactDbVar(e, p)] ^ (unsigned)ExactDbNeg(e, p);
+    if (b.cost == 0) return (b.root ? lit[0] : 0u) ^ (unsigned)ExactDbOutNeg(e);
+    for (int i = 0; i < b.cost; ++i) {
+        const ChainGate& g = b.gates[i];
+        lit[4 + i] = strash.And(lit[g.k] ^ (unsigned)(g.pol & 1), lit[g.j] ^ (unsigned)(g.pol >> 1));
+    }
+    return lit[3 + b.cost] ^ (unsigned)ExactDbOutNeg(e);
+}
+
+// 已有結構的直接接上，否則在 v 上做 Shannon 展開（cofactor 一定比較小）
+unsigned ShannonBuild(const std::vector<uint32_t>& func, const std::vector<ClassBest>& best, uint16_t f, int v,
+                      AigStrash& strash) {
+    const unsigned pis[4] = {strash.PiLit(0), strash.PiLit(1), strash.PiLit(2), strash.PiLit(3)};
+    if (func[f] && best[ExactDbClassOf(func[f])].cost >= 0) return Instantiate(func, best, f, pis, strash);
+    auto sub = [&](uint16_t g) {
+        for (int w = 0; w < 4; ++w)
+            if (Cofactor(g, w, 0) != Cofactor(g, w, 1)) return ShannonBuild(func, best, g, w, strash);
+        return g ? 1u : 0u;
+    };
+    unsigned f0 = sub(Cofactor(f, v, 0)), f1 = sub(Cofactor(f, v, 1));
+    unsigned a = strash.And(pis[v], f1), b = strash.And(pis[v] ^ 1u, f0);
+    return strash.And(a ^ 1u, b ^ 1u) ^ 1u;
+}
+
+// 只有 class root 的 16-bit 模擬，用來檢查每個函數的 instantiation
+uint16_t Simulate(const AigGraph& g) {
+    std::vector<uint16_t> val(g.MaxVar() + 1, 0);
+    for (int i = 0; i < g.nPis; ++i) val[1 + i] = (uint16_t)s_TruthVar6[i];
+    auto lit = [&](unsigned l) { return (uint16_t)(val[l >> 1] ^ ((l & 1u) ? 0xFFFF : 0)); };
+    for (int k = 0; k < g.AndNum(); ++k) val[g.AndLit(k) >> 1] = lit(g.fanin0[k]) & lit(g.fanin1[k]);
+    return lit(g.outputs[0]);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = ExactDb::DefaultPath();
+    int maxGates = 8;
+    int nWorkers = std::max(1u, std::thread::hardware_concurrency());
+    bool force = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.find("db=") == 0) path = arg.substr(3);
+            else if (arg.find("gates=") == 0) maxGates = std::max(1, std::min(EXACT_DB_MAX_ANDS - 8, std::stoi(arg.substr(6))));
+            else if (arg.find("workers=") == 0) nWorkers = std::max(1, std::stoi(arg.substr(8)));
+            else if (arg == "force=1") force = true;
+            else {
+                std::cerr << "Usage: " << argv[0] << " [db=<path>] [gates=<int>] [workers=<int>] [force=1]" << std::endl;
+                std::cerr << "  db=<path>      Output file (Default: $AIGMIN_EXACT_DB or results/exactdb/npn4.db)" << std::endl;
+                std::cerr << "  gates=<int>    Enumerate every AIG up to this many ANDs (Default: 8)" << std::endl;
+                std::cerr << "  workers=<int>  Enumeration threads (Default: all cores)" << std::endl;
+                std::cerr << "  force=1        Rebuild even if the file is up to date" << std::endl;
+                return 1;
+            }
+        } catch (...) { std::cerr << "[Warn] Invalid argument ignored: " << arg << std::endl; }
+    }
+
+    std::string err;
+    {
+        ExactDb db;
+        if (!force && db.Open(path, err) && (int)db.Header().maxExact >= maxGates) {
+            std::cout << "[ExactDB] " << path << " is up to date (" << db.Header().nClasses << " classes, exact up to "
+                      << db.Header().maxExact << " ANDs)." << std::endl;
+            return 0;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> classes;
+    std::vector<uint16_t> roots;
+    ExactDbClasses(classes, roots);
+    int nClasses = (int)roots.size();
+    std::cout << "[ExactDB] " << nClasses << " NPN classes of 4-input functions; enumerating chains up to "
+              << maxGates << " ANDs on " << nWorkers << " workers..." << std::endl;
+
+    // ------- 窮舉：依第二個 AND 分成互不相干的子樹 -------
+    std::vector<int> keys = ChainEnumerator::SecondKeys();
+    keys.insert(keys.begin(), -1);
+    std::vector<std::vector<ClassBest>> partial(keys.size());
+    std::vector<uint64_t> visited(keys.size(), 0);
+    std::vector<int> order(keys.size());
+    for (size_t t = 0; t < keys.size(); ++t) order[t] = (int)t;
+    ParallelForEach(order, nWorkers, [&](int t) {
+        ChainEnumerator en(classes, nClasses, maxGates);
+        en.Run(keys[t]);
+        partial[t] = std::move(en.Best());
+        visited[t] = en.Visited();
+    });
+
+    std::vector<ClassBest> best(nClasses);
+    best[ExactDbClassOf(classes[0x0000])] = {0, 0x0000, {}};
+    best[ExactDbClassOf(classes[0xAAAA])] = {0, 0xAAAA, {}};
+    uint64_t nVisited = 0;
+    for (size_t t = 0; t < keys.size(); ++t) {  // 依 task 順序合併，結果與 worker 數無關
+        nVisited += visited[t];
+        for (int c = 0; c < nClasses; ++c)
+            if (partial[t][c].cost >= 0 && (best[c].cost < 0 || partial[t][c].cost < best[c].cost))
+                best[c] = std::move(partial[t][c]);
+    }
+
+    // transform 以找到的 chain 所算的函數為 root
+    ExactDbImage image;
+    image.maxExact = (uint32_t)maxGates;
+    image.func.assign(EXACT_DB_FUNCS, 0);
+    std::vector<char> exact(nClasses, 0);
+    for (int c = 0; c < nClasses; ++c) {
+        if (best[c].cost < 0) continue;
+        exact[c] = 1;
+        ExactDbOrbit(best[c].root, c, image.func);
+    }
+
+    // ------- 剩下的 class：最小的 Shannon 展開 -------
+    int nLeft = 0;
+    for (int c = 0; c < nClasses; ++c) {
+        if (best[c].cost >= 0) continue;
+        ++nLeft;
+        AigGraph bestAig;
+        for (int v = 0; v < 4; ++v) {
+            if (Cofactor(roots[c], v, 0) == Cofactor(roots[c], v, 1)) continue;
+            AigStrash strash(4);
+            AigGraph g;
+            strash.Finish({ShannonBuild(image.func, best, roots[c], v, strash)}, g);
+            if (bestAig.outputs.empty() || g.AndNum() < bestAig.AndNum()) bestAig = std::move(g);
+        }
+        if (bestAig.AndNum() > EXACT_DB_MAX_ANDS) {
+            std::cerr << "[ExactDB] Class " << c << " needs " << bestAig.AndNum() << " ANDs." << std::endl;
+            return 1;
+        }
+        ClassBest& b = best[c];
+        b.cost = bestAig.AndNum();
+        b.root = roots[c];
+        auto node = [](unsigned l) { return (int)(l >> 1) - 1; };  // AigGraph var -> chain node index
+        for (int k = 0; k < bestAig.AndNum(); ++k)
+            b.gates.push_back({node(bestAig.fanin0[k]), node(bestAig.fanin1[k]),
+                               (int)(bestAig.fanin0[k] & 1u) | (int)(bestAig.fanin1[k] & 1u) << 1});
+        if (bestAig.outputs[0] & 1u) {
+            // output 反相時 root 改用補數（與原本同一個 class）
+            b.root = (uint16_t)~b.root;
+        }
+        ExactDbOrbit(b.root, c, image.func);
+    }
+
+    // ------- 寫成檔案格式 -------
+    for (int c = 0; c < nClasses; ++c) {
+        const ClassBest& b = best[c];
+        ExactDbClass rec{};
+        rec.firstAnd = (uint32_t)(image.fanins.size() / 2);
+        rec.nAnds = (uint16_t)b.cost;
+        rec.root = b.root;
+        rec.flags = exact[c] ? EXACT_DB_FLAG_EXACT : 0;
+        for (const ChainGate& g : b.gates) {
+            unsigned l0 = 2u * (unsigned)(g.k + 1) ^ (unsigned)(g.pol & 1);
+            unsigned l1 = 2u * (unsigned)(g.j + 1) ^ (unsigned)(g.pol >> 1);
+            image.fanins.push_back((uint16_t)l0);
+            image.fanins.push_back((uint16_t)l1);
+        }
+        rec.outLit = (uint16_t)(b.cost == 0 ? (b.root ? 2 : 0) : 2 * (4 + b.cost));
+        image.cls.push_back(rec);
+    }
+
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent);
+    if (!image.Write(path, err)) {
+        std::cerr << "[ExactDB] " << err << std::endl;
+        return 1;
+    }
+
+    // ------- 讀回來檢查每一個函數 -------
+    ExactDb db;
+    if (!db.Open(path, err)) {
+        std::cerr << "[ExactDB] " << err << std::endl;
+        return 1;
+    }
+    for (int f = 0; f < EXACT_DB_FUNCS; ++f) {
+        AigStrash strash(4);
+        const unsigned pis[4] = {strash.PiLit(0), strash.PiLit(1), strash.PiLit(2), strash.PiLit(3)};
+        AigGraph g;
+        strash.Finish({db.Build((uint16_t)f, pis, strash)}, g);
+        if (Simulate(g) != f || g.AndNum() > db.Cost((uint16_t)f)) {
+            std::cerr << "[ExactDB] Self-check failed on function 0x" << std::hex << f << std::dec << std::endl;
+            std::remove(path.c_str());
+            return 1;
+        }
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<int> hist(EXACT_DB_MAX_ANDS + 1, 0);
+    for (int c = 0; c < nClasses; ++c) ++hist[best[c].cost];
+    std::cout << "[ExactDB] " << nVisited << " chains, " << nClasses - nLeft << " classes exact, " << nLeft
+              << " by Shannon expansion (" << secs << "s)." << std::endl;
+    for (int n = 0; n <= EXACT_DB_MAX_ANDS; ++n)
+        if (hist[n]) std::cout << "          " << n << " ANDs: " << hist[n] << " classes" << std::endl;
+    std::cout << "[ExactDB] Written to " << path << std::endl;
+    return 0;
+}
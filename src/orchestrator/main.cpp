@@ -0,0 +1,418 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+
+// ABC Headers
+#include "base/abc/abc.h"
+#include "base/main/main.h"
+
+#include "common/truth_table.h"
+#include "common/abc_aig.h"
+#include "common/aig_check.h"
+#include "common/aig_incremental.h"
+#include "common/aig_rewrite.h"
+#include "common/aiger.h"
+#include "common/result_cache.h"
+#include "common/stage_timer.h"
+#include "common/truth_npn.h"
+#include "common/scratch.h"
+#include "eslim/eslim_iterative.h"
+#include "simplifier/simplifier_pass.h"
+
+// =========================================================
+// IWLS optimization pipeline (replaces scripts/optimize.sh)
+//
+// One process for the whole case:
+//   - the golden function (truth table) and the current best AIG stay in
+//     memory; the initial AIG is checked against the golden function
+//     (exhaustive simulation, common/aig_check.h), and every pass result
+//     is checked incrementally against the current best, which re-checks
+//     only the outputs whose cones changed (common/aig_incremental.h)
+//   - ABC runs in-process, the eSLIM workers are started once and reused
+//     by every eSLIM pass
+//   - the deadline is tracked with a monotonic clock
+//   - outputs of a .truth input that are NPN-equivalent (common/truth_npn.h)
+//     are optimized once: every pass sees one output per class, and the
+//     full AIG is rebuilt and checked against the input right before the
+//     output file is written, once, at the end
+//   - results are shared across runs through the result cache
+//     (common/result_cache.h): a cached AIG for the same function is the
+//     warm start, and a better final result is written back
+//   - 4-input cuts (and whole outputs with at most 4 inputs) are rewritten
+//     in-process with the exact-synthesis database (common/exact_db.h)
+//     when it has been built (bin/exactdb/main)
+//   - with $AIGMIN_STAGE_LOG set, the time and memory of every stage
+//     (parse, build, abc, each pass, verify, ...) is logged for the
+//     benchmark harness (common/stage_timer.h, src/bench)
+// =========================================================
+
+const std::string TEAMMATE_EXEC = "./bin/teammate_b/optimizer";
+
+struct Deadline {
+    std::chrono::steady_clock::time_point end;
+
+    explicit Deadline(int seconds) : end(std::chrono::steady_clock::now() + std::chrono::seconds(seconds)) {}
+    int Remaining() const {
+        return (int)std::chrono::duration_cast<std::chrono::seconds>(end - std::chrono::steady_clock::now()).count();
+    }
+};
+
+// =========================================================
+// Golden reference
+// =========================================================
+
+struct Golden {
+    bool exhaustive = false;  // true: tt 是完整的真值表，用 exhaustive 模擬比對
+    TruthTable tt;
+    AigGraph aig;             // .aig 輸入且輸入太多時，用 cec 比對
+};
+
+// 見 common/aig_check.h；輸入太多時退回 ABC cec（common/abc_aig.h）
+bool CheckAgainstGolden(const Golden& golden, const AigGraph& g, std::string& err) {
+    AigCheckResult res;
+    bool decided = golden.exhaustive ? AigCheckTruth(g, golden.tt, res, err)
+                                     : AigCheckEquivalent(golden.aig, g, res, err);
+    if (!decided) return false;
+    if (!res.equivalent) {
+        err = res.reason;
+        return false;
+    }
+    return true;
+}
+
+// =========================================================
+// Passes
+// =========================================================
+
+// 每個 pass 把目前最好的 AIG 轉成一個新的 AIG；失敗時回傳 false（不影響目前的結果）
+struct OptPass {
+    std::string name;
+    std::string stage;  // common/stage_timer.h 的 stage 名稱
+    std::function<bool(const AigGraph& in, int timeLimit, AigGraph& out, std::string& err)> run;
+};
+
+// 把 in 交給外部執行檔（<exe> <in.aig> <out.aig>），用 timeout(1) 限制時間
+bool RunExternalPass(const std::string& exe, const ScratchDir& scratch, const AigGraph& in, int timeLimit,
+                     AigGraph& out, std::string& err) {
+    std::string inFile = scratch.File("ext_in.aig");
+    std::string outFile = scratch.File("ext_out.aig");
+    std::remove(outFile.c_str());
+    if (!AigerWrite(inFile, in, err)) return false;
+    std::string cmd = "timeout " + std::to_string(std::max(1, timeLimit)) + " " + exe + " " + inFile + " " + outFile;
+    if (std::system(cmd.c_str()) != 0) {
+        err = exe + " failed";
+        return false;
+    }
+    return AigerRead(outFile, out, err);
+}
+
+// =========================================================
+// MAIN
+// =========================================================
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.truth|input.tbin|input.aig> <output.aig> [time_limit] [options]" << std::endl;
+        std::cerr << "Options (key=value):" << std::endl;
+        std::cerr << "  time_limit=<int>   Total runtime budget in seconds (Default: 3600)" << std::endl;
+        std::cerr << "  iter_time=<int>    eSLIM step budget in seconds (Default: 600)" << std::endl;
+        std::cerr << "  rounds=<int>       Simplifier/eSLIM/teammate rounds after the initial pass (Default: 5)" << std::endl;
+        std::cerr << "  workers=<int>      Concurrent eSLIM instances, 0 = all cores (Default: 1)" << std::endl;
+        std::cerr << "  seed=<int>         eSLIM base seed, 0 = default (Default: 1)" << std::endl;
+        std::cerr << "  npn=<0|1>          Optimize one output per NPN class of a .truth input (Default: 1)" << std::endl;
+        std::cerr << "  cache=<dir|off>    Result cache directory (Default: $AIGMIN_CACHE or results/cache)" << std::endl;
+        std::cerr << "  exact_db=<file|off> Exact-synthesis database (Default: $AIGMIN_EXACT_DB or results/exactdb/npn4.db)" << std::endl;
+        return 1;
+    }
+
+    std::string inputFile = argv[1];
+    std::string outputFile = argv[2];
+    int totalTimeLimit = 3600;
+    int nRounds = 5;
+    EslimConfig eslimConfig;
+    eslimConfig.iterTimeLimit = 600;
+    std::string cacheDir = ResultCache::DefaultDir();
+    std::string exactDbPath = ExactDb::DefaultPath();
+    bool useNpn = true;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            // optimize.sh 的第三個參數是總時間
+            if (i == 3 && !arg.empty() && std::isdigit((unsigned char)arg[0])) totalTimeLimit = std::stoi(arg);
+            else if (arg.find("time_limit=") == 0) totalTimeLimit = std::stoi(arg.substr(11));
+            else if (arg.find("iter_time=") == 0) eslimConfig.iterTimeLimit = std::stoi(arg.substr(10));
+            else if (arg.find("rounds=") == 0) nRounds = std::stoi(arg.substr(7));
+            else if (arg.find("seed=") == 0) eslimConfig.seed = (unsigned)std::stoul(arg.substr(5));
+            else if (arg.find("npn=") == 0) useNpn = std::stoi(arg.substr(4)) != 0;
+            else if (arg.find("cache=") == 0) cacheDir = arg.substr(6) == "off" ? "" : arg.substr(6);
+            else if (arg.find("exact_db=") == 0) exactDbPath = arg.substr(9) == "off" ? "" : arg.substr(9);
+            else if (arg.find("workers=") == 0) {
+                eslimConfig.nWorkers = std::stoi(arg.substr(8));
+                if (eslimConfig.nWorkers <= 0) eslimConfig.nWorkers = std::max(1u, std::thread::hardware_concurrency());
+            }
+            else std::cerr << "[Warn] Unknown argument: " << arg << std::endl;
+        } catch (...) { std::cerr << "[Warn] Invalid argument ignored: " << arg << std::endl; }
+    }
+    EslimFinalizeConfig(eslimConfig);
+
+    Deadline deadline(totalTimeLimit);
+    std::cout << "[Config] Total Limit: " << totalTimeLimit << "s | eSLIM Step: " << eslimConfig.iterTimeLimit
+              << "s | Rounds: " << nRounds << " | Workers: " << eslimConfig.nWorkers
+              << " | Seed: " << eslimConfig.seed << std::endl;
+
+    ScratchDir scratch;
+    std::string err;
+    if (!scratch.Create("orchestrator", err)) {
+        std::cerr << "[Error] " << err << std::endl;
+        return 1;
+    }
+
+    Abc_Start();
+    Abc_Frame_t* pAbc = Abc_FrameGetGlobalFrame();
+
+    // ==================== Phase 1: golden reference + initial AIG ====================
+    Golden golden;
+    AigGraph best;
+    TruthNpnClasses npn;  // npn.Reduced() 時 golden.tt 只含每個 class 的代表，best 也是
+    TruthTable fullTT;
+    std::string ext;
+    size_t dot = inputFile.find_last_of('.');
+    if (dot != std::string::npos) ext = inputFile.substr(dot);
+
+    StageTimer parseStage("parse");
+    if (TruthIsTableFile(inputFile)) {
+        if (!LoadTruthFile(inputFile, golden.tt, err)) {
+            std::cerr << "[Error] " << err << std::endl;
+            Abc_Stop();
+            return 1;
+        }
+        parseStage.Stop();
+        golden.exhaustive = true;
+        std::cout << "[Phase 1] ABC synthesis..." << std::endl;
+        if (!AbcSynthesizeTruth(pAbc, golden.tt, best, err, false)) {
+            std::cerr << "[Error] ABC synthesis failed: " << err << std::endl;
+            Abc_Stop();
+            return 1;
+        }
+        if (useNpn) TruthNpnClassify(golden.tt, npn);
+        if (npn.Reduced()) {
+            // 接線的複本不能和其他 output 共用邏輯：代表接回去之後不比直接合成大，才只最佳化代表
+            TruthTable reps;
+            AigGraph repAig, expanded;
+            TruthNpnRepresentatives(golden.tt, npn, reps);
+            if (!AbcSynthesizeTruth(pAbc, reps, repAig, err, false)) {
+                std::cerr << "[Error] ABC synthesis failed: " << err << std::endl;
+                Abc_Stop();
+                return 1;
+            }
+            AigNpnExpand(repAig, npn, expanded);
+            std::cout << "[NPN] " << golden.tt.nOuts << " outputs -> " << npn.nClasses << " classes: "
+                      << expanded.AndNum() << " AND gates expanded vs " << best.AndNum() << " direct";
+            if (expanded.AndNum() <= best.AndNum()) {
+                std::cout << "; optimizing the representatives." << std::endl;
+                fullTT = std::move(golden.tt);
+                golden.tt = std::move(reps);
+                best = std::move(repAig);
+            } else {
+                std::cout << "; keeping all outputs." << std::endl;
+                npn = TruthNpnClasses();
+            }
+        }
+    } else if (ext == ".aig") {
+        if (!AigerRead(inputFile, best, err)) {
+            std::cerr << "[Error] " << err << std::endl;
+            Abc_Stop();
+            return 1;
+        }
+        if (best.nLatches > 0) {
+            std::cerr << "[Error] Sequential AIGs are not supported." << std::endl;
+            Abc_Stop();
+            return 1;
+        }
+        golden.aig = best;
+        golden.exhaustive = AigSimulateTruth(best, golden.tt, err);
+        parseStage.Stop();
+    } else {
+        std::cerr << "[Error] Unknown file extension: " << ext << std::endl;
+        Abc_Stop();
+        return 1;
+    }
+    StageTimer verifyStage("verify");
+    if (!CheckAgainstGolden(golden, best, err)) {
+        std::cerr << "[Fatal] Initial AIG does not match the input (" << err << ")." << std::endl;
+        Abc_Stop();
+        return 1;
+    }
+    verifyStage.Stop();
+    std::cout << "[Phase 1] Initial AIG: " << best.AndNum() << " AND gates ("
+              << (golden.exhaustive ? "exhaustive" : "cec") << " checking)." << std::endl;
+
+    // 同一個函數以前的最佳結果（只有完整真值表才有 key）；載入的結果一樣要通過 golden 比對
+    ResultCache cache;
+    if (!cacheDir.empty() && golden.exhaustive && !cache.Open(cacheDir, err))
+        std::cerr << "[Cache] " << err << " (disabled)" << std::endl;
+    int cachedGates = -1;
+    if (cache.Valid()) {
+        StageTimer cacheStage("cache");
+        AigGraph cached;
+        ResultCacheEntry entry;
+        if (!cache.Lookup(golden.tt, cached, entry)) {
+            std::cout << "[Cache] Miss." << std::endl;
+        } else if (!CheckAgainstGolden(golden, cached, err)) {
+            std::cerr << "[Cache] Entry rejected (" << err << ")." << std::endl;
+        } else {
+            cachedGates = cached.AndNum();
+            std::cout << "[Cache] Hit: " << cachedGates << " AND gates (" << entry.provenance << ")." << std::endl;
+            if (cachedGates < best.AndNum()) best = std::move(cached);
+        }
+    }
+
+    AigIncrementalVerifier verifier;  // best 一定已經驗證過，之後的結果只要和 best 比對
+    verifier.Reset(best);
+
+    // ==================== Passes ====================
+    EslimPortfolio portfolio;  // eSLIM worker 只啟動一次，每個 eSLIM pass 共用
+    OptPass eslimPass{"eSLIM", "eslim", [&](const AigGraph& in, int timeLimit, AigGraph& out, std::string& perr) {
+        std::string inFile = scratch.File("eslim_in.aig");
+        std::string outFile = scratch.File("eslim_out.aig");
+        if (!AigerWrite(inFile, in, perr)) return false;
+        EslimConfig config = eslimConfig;
+        config.totalTimeLimit = timeLimit;
+        if (run_iterative_eslim(inFile, outFile, config, scratch, &portfolio) != 0) {
+            perr = "eSLIM failed";
+            return false;
+        }
+        return AigerRead(outFile, out, perr);
+    }};
+    OptPass simplifierPass{"Simplifier", "simplifier", [&](const AigGraph& in, int timeLimit, AigGraph& out, std::string& perr) {
+        return RunSimplifierPass(pAbc, in, scratch, out, perr, timeLimit);
+    }};
+    OptPass teammatePass{"Teammate B", "teammate", [&](const AigGraph& in, int timeLimit, AigGraph& out, std::string& perr) {
+        return RunExternalPass(TEAMMATE_EXEC, scratch, in, timeLimit, out, perr);
+    }};
+
+    ExactDb exactDb;
+    if (!exactDbPath.empty() && !exactDb.Open(exactDbPath, err))
+        std::cout << "[ExactDB] " << err << " (skipping; build it with bin/exactdb/main)" << std::endl;
+    OptPass exactPass{"ExactDB", "exactdb", [&](const AigGraph& in, int, AigGraph& out, std::string& perr) {
+        // 重寫到沒有進步為止
+        AigGraph cur = in;
+        AigRewriteStats st;
+        int nIters = 0;
+        while (AigExactRewrite(cur, exactDb, out, &st)) {
+            cur = std::move(out);
+            ++nIters;
+        }
+        if (nIters == 0) {
+            perr = "No smaller rewrite";
+            return false;
+        }
+        out = std::move(cur);
+        return true;
+    }};
+
+    std::vector<OptPass> roundPasses;
+    if (exactDb.Valid()) roundPasses.push_back(exactPass);
+    if (SimplifierAvailable()) roundPasses.push_back(simplifierPass);
+    else std::cout << "[Simplifier] Binary missing (skipping)..." << std::endl;
+    roundPasses.push_back(eslimPass);
+    if (std::filesystem::exists(TEAMMATE_EXEC)) roundPasses.push_back(teammatePass);
+    else std::cout << "[Teammate B] Binary missing (skipping)..." << std::endl;
+
+    // 跑一個 pass；結果與 best 等價且不比目前大才接受
+    auto runPass = [&](const OptPass& pass) {
+        int remaining = deadline.Remaining();
+        if (remaining <= 0) return false;
+        std::cout << "[" << pass.name << "] Running... (Max: " << remaining << "s)" << std::endl;
+        auto passStart = std::chrono::steady_clock::now();
+        AigGraph next;
+        std::string perr;
+        StageTimer passStage(pass.stage);
+        bool ok = pass.run(best, remaining, next, perr);
+        passStage.Stop();
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - passStart).count();
+        if (!ok) {
+            std::cerr << "   [Skip] " << perr << " (" << secs << "s)" << std::endl;
+            return true;
+        }
+        AigCheckResult res;
+        StageTimer verifyStage("verify");
+        if (!verifier.Check(next, res, perr, AigCheckEquivalent) || !res.equivalent) {
+            std::cerr << "   [FAIL] Verification Failed (" << (res.reason.empty() ? perr : res.reason)
+                      << "). Discarding result." << std::endl;
+            return true;
+        }
+        verifyStage.Stop();
+        const AigIncrementalStats& st = verifier.Stats();
+        std::cout << "   [Pass] Verified: " << best.AndNum() << " -> " << next.AndNum() << " AND gates (" << secs
+                  << "s); " << st.nChanged << "/" << st.nOutputs << " outputs changed, " << st.nSimulated
+                  << " new nodes, " << st.nFullCones << " full cones." << std::endl;
+        if (next.AndNum() <= best.AndNum()) {
+            verifier.Commit(next);
+            best = std::move(next);
+        }
+        else std::cout << "   [Keep] Result is larger; keeping the current best." << std::endl;
+        return true;
+    };
+
+    // ==================== Phase 1b: initial exact rewrite + eSLIM pass ====================
+    if (exactDb.Valid()) runPass(exactPass);
+    runPass(eslimPass);
+
+    // ==================== Phase 2: optimization loop ====================
+    for (int round = 1; round <= nRounds; ++round) {
+        if (deadline.Remaining() <= 0) {
+            std::cout << "[Timeout] Global time limit reached." << std::endl;
+            break;
+        }
+        std::cout << "--- Iteration " << round << " / " << nRounds << " ---" << std::endl;
+        for (const OptPass& pass : roundPasses)
+            if (!runPass(pass)) break;
+    }
+
+    // ==================== 只在最後寫一次輸出 ====================
+    AigGraph result;
+    if (npn.Reduced()) {
+        // 代表接回所有 output，再對完整的輸入檢查一次
+        AigNpnExpand(best, npn, result);
+        AigCheckResult res;
+        StageTimer finalStage("verify");
+        if (!AigCheckTruth(result, fullTT, res, err) || !res.equivalent) {
+            std::cerr << "[Fatal] NPN expansion does not match the input (" << (res.reason.empty() ? err : res.reason)
+                      << ")." << std::endl;
+            Abc_Stop();
+            return 1;
+        }
+        finalStage.Stop();
+        std::cout << "[NPN] Expanded " << npn.nClasses << " -> " << fullTT.nOuts << " outputs: " << best.AndNum()
+                  << " -> " << result.AndNum() << " AND gates." << std::endl;
+    } else {
+        result = best;
+    }
+    StageTimer writeStage("write");
+    if (!AigerWrite(outputFile, result, err)) {
+        std::cerr << "[Error] " << err << std::endl;
+        Abc_Stop();
+        return 1;
+    }
+    writeStage.Stop();
+    std::cout << "[System] Saved best result (" << result.AndNum() << " AND gates) to: " << outputFile << std::endl;
+    if (cache.Valid() && (cachedGates < 0 || best.AndNum() < cachedGates)) {
+        bool improved = false;
+        if (!cache.Store(golden.tt, best, ResultCache::Provenance("orchestrator", inputFile, best.AndNum()), err, &improved))
+            std::cerr << "[Cache] " << err << std::endl;
+        else if (improved)
+            std::cout << "[Cache] Stored " << best.AndNum() << " AND gates." << std::endl;
+    }
+    Abc_Stop();
+    return 0;
+}
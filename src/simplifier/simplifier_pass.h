@@ -0,0 +1,60 @@
+#ifndef SIMPLIFIER_PASS_H
+#define SIMPLIFIER_PASS_H
+
+// =========================================================
+// External simplifier as an AigGraph -> AigGraph pass
+//
+// The AIG is written as BENCH into the scratch directory, the simplifier
+// binary is run on it, and its result is read back and strashed with the
+// in-process ABC frame (Abc_Start() must have been called).  The result is
+// also left in the ABC frame as the current network.
+// =========================================================
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include "base/abc/abc.h"
+#include "base/main/main.h"
+
+#include "common/abc_aig.h"
+#include "common/aiger.h"
+#include "common/scratch.h"
+
+// ================= 路徑設定 =================
+inline const std::string SIMPLIFIER_EXEC = "./third_party/simplifier/build/simplifier";
+inline const std::string SIMPLIFIER_DB = "./third_party/simplifier/databases";
+
+inline bool SimplifierAvailable() { return std::filesystem::exists(SIMPLIFIER_EXEC); }
+
+// timeLimit > 0 時用 timeout(1) 限制 simplifier 的執行時間
+inline bool RunSimplifierPass(Abc_Frame_t* pAbc, const AigGraph& in, const ScratchDir& scratch, AigGraph& out,
+                              std::string& err, int timeLimit = 0) {
+    std::string temp_bench_clean = "case.bench";
+    std::string dir_in = scratch.SubDir("in");
+    std::string dir_out = scratch.SubDir("out");
+    std::string sim_result_bench = dir_out + "/" + temp_bench_clean;
+
+    // 同一個工作區可能跑很多次，先清掉上一次的結果
+    std::error_code ec;
+    std::filesystem::remove(sim_result_bench, ec);
+
+    if (!AigWriteBench(dir_in + "/" + temp_bench_clean, in, err)) return false;
+
+    // 拿掉 /dev/null 以便除錯
+    std::string sim_cmd = SIMPLIFIER_EXEC + " -i " + dir_in + " -o " + dir_out + " --basis BENCH --databases " + SIMPLIFIER_DB;
+    if (timeLimit > 0) sim_cmd = "timeout " + std::to_string(timeLimit) + " " + sim_cmd;
+
+    int ret = std::system(sim_cmd.c_str());
+    if (ret != 0 || !std::filesystem::exists(sim_result_bench)) {
+        err = "Simplifier failed";
+        return false;
+    }
+    if (!ExecAbcCmd(pAbc, "read_bench " + sim_result_bench + "; strash")) {
+        err = "Could not convert simplifier result";
+        return false;
+    }
+    return AbcNtkToAigGraph(Abc_FrameReadNtk(pAbc), out, err);
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "common/truth_table.h"
+
+// =========================================================
+// Truth-table converter (.truth <-> .tbin, common/truth_table.h)
+//
+// Usage: main <in.truth|in.tbin> <out.tbin|out.truth>
+//        main <dir>     every <dir>/*.truth -> <dir>/*.tbin (skips files
+//                       whose .tbin is newer)
+//
+// The output format follows the output extension.  Every written file is
+// read back and compared with the input.
+// =========================================================
+
+static bool Convert(const std::string& in, const std::string& out) {
+    TruthTable tt, back;
+    std::string err;
+    if (!LoadTruthFile(in, tt, err)) {
+        std::cerr << "[Convert] " << err << std::endl;
+        return false;
+    }
+    bool binary = out.size() >= 5 && out.compare(out.size() - 5, 5, ".tbin") == 0;
+    bool ok = binary ? TruthWriteBinary(out, tt, err) : TruthWriteText(out, tt, err);
+    if (ok) ok = LoadTruthFile(out, back, err);
+    if (ok && (back.nVars != tt.nVars || back.nOuts != tt.nOuts || back.words != tt.words)) {
+        err = "Read-back mismatch for " + out;
+        ok = false;
+    }
+    if (!ok) {
+        std::cerr << "[Convert] " << err << std::endl;
+        std::remove(out.c_str());
+        return false;
+    }
+    std::error_code ec;
+    std::cout << "[Convert] " << in << " -> " << out << " (" << tt.nVars << " inputs, " << tt.nOuts << " outputs, "
+              << std::filesystem::file_size(in, ec) << " -> " << std::filesystem::file_size(out, ec) << " bytes)"
+              << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::filesystem::is_directory(argv[1])) {
+        std::vector<std::string> inputs;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(argv[1], ec))
+            if (entry.path().extension() == ".truth") inputs.push_back(entry.path().string());
+        std::sort(inputs.begin(), inputs.end());
+        int nFailed = 0;
+        for (const std::string& in : inputs) {
+            std::string out = in.substr(0, in.size() - 6) + ".tbin";
+            if (std::filesystem::exists(out, ec) &&
+                std::filesystem::last_write_time(out, ec) >= std::filesystem::last_write_time(in, ec))
+                continue;
+            if (!Convert(in, out)) ++nFailed;
+        }
+        return nFailed == 0 ? 0 : 1;
+    }
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <in.truth|in.tbin> <out.tbin|out.truth>" << std::endl;
+        std::cerr << "       " << argv[0] << " <dir>   (every .truth in <dir> -> .tbin)" << std::endl;
+        return 1;
+    }
+    return Convert(argv[1], argv[2]) ? 0 : 1;
+}